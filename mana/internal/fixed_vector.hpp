@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_FIXED_VECTOR_HPP
+#define MANA_FIXED_VECTOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace ManaVK::Internal {
+    // A vector with inline, fixed capacity storage, it never touches the heap
+    // Used on the per-frame path for the small lists Vulkan wants (semaphores, clear values, etc...)
+    // T must be default constructible, unused slots are kept as default values
+    template<typename T, size_t N>
+    class FixedVector {
+    protected:
+        std::array<T, N> items {};
+        size_t count = 0;
+
+    public:
+        FixedVector() = default;
+
+        FixedVector(std::initializer_list<T> list) {
+            for (const T& item : list) {
+                push_back(item);
+            }
+        }
+
+        void push_back(const T& item) {
+            if (count >= N) {
+                throw std::runtime_error("FixedVector is full! Increase its capacity!");
+            }
+
+            items[count++] = item;
+        }
+
+        void pop_back() {
+            if (count == 0) {
+                throw std::runtime_error("FixedVector is empty!");
+            }
+
+            items[--count] = T{};
+        }
+
+        void clear() {
+            for (size_t i = 0; i < count; i++) {
+                items[i] = T{};
+            }
+
+            count = 0;
+        }
+
+        //
+        // Access
+        //
+        T& operator[](size_t index) {
+            return items[index];
+        }
+
+        const T& operator[](size_t index) const {
+            return items[index];
+        }
+
+        T& back() {
+            return items[count - 1];
+        }
+
+        T* data() {
+            return items.data();
+        }
+
+        const T* data() const {
+            return items.data();
+        }
+
+        T* begin() {
+            return items.data();
+        }
+
+        T* end() {
+            return items.data() + count;
+        }
+
+        const T* begin() const {
+            return items.data();
+        }
+
+        const T* end() const {
+            return items.data() + count;
+        }
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        size_t size() const {
+            return count;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return count == 0;
+        }
+
+        [[nodiscard]]
+        static constexpr size_t capacity() {
+            return N;
+        }
+    };
+}
+
+#endif//MANA_FIXED_VECTOR_HPP
@@ -0,0 +1,261 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_buffer.hpp"
+
+#include <mana/internal/vulkan_instance.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <iostream>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanBuffer]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+using namespace ManaVK::Internal;
+
+VulkanBuffer::VulkanBuffer(VulkanInstance *vulkan_instance, const BufferSettings &settings) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (settings.size == 0) {
+        throw std::runtime_error("Buffer size was 0!");
+    }
+
+    this->size = settings.size;
+    this->memory_usage = settings.memory_usage;
+
+    //
+    // Placement
+    //
+    VkBufferUsageFlags vk_usage_flags = settings.vk_usage_flags;
+    VmaAllocationCreateInfo vma_alloc_info {};
+
+    switch (settings.memory_usage) {
+        case MemoryUsage::GPUOnly:
+            // The only way to fill device local memory is a transfer
+            vk_usage_flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+            vma_alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            break;
+
+        case MemoryUsage::Stream:
+            vma_alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+            vma_alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+            break;
+
+        case MemoryUsage::Readback:
+            vk_usage_flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+            // Reading uncached (write combined) memory is extremely slow, so ask for random access
+            vma_alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+            vma_alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+            break;
+    }
+
+    bool host_visible = settings.memory_usage != MemoryUsage::GPUOnly;
+
+    if (host_visible && settings.persistent_map) {
+        vma_alloc_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        persistent_map = true;
+    }
+
+    //
+    // Buffer creation
+    //
+    VkBufferCreateInfo buffer_info {};
+    {
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+
+        buffer_info.size = settings.size;
+        buffer_info.usage = vk_usage_flags;
+        buffer_info.sharingMode = settings.vk_sharing_mode;
+    }
+
+    VmaAllocationInfo vma_allocation_info {};
+
+    VkResult result = vmaCreateBuffer(vulkan_instance->get_vma_allocator(), &buffer_info, &vma_alloc_info, &vk_buffer, &vma_allocation, &vma_allocation_info);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vmaCreateBuffer failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vmaCreateBuffer failed! Please check the log above for more info!");
+    }
+
+    mapped_data = vma_allocation_info.pMappedData;
+
+    VkMemoryPropertyFlags vk_memory_flags = 0;
+    vmaGetAllocationMemoryProperties(vulkan_instance->get_vma_allocator(), vma_allocation, &vk_memory_flags);
+
+    coherent = (vk_memory_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+void VulkanBuffer::release(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    if (vk_buffer != nullptr) {
+        if (mapped_data != nullptr && !persistent_map) {
+            vmaUnmapMemory(vulkan_instance->get_vma_allocator(), vma_allocation);
+        }
+
+        vmaDestroyBuffer(vulkan_instance->get_vma_allocator(), vk_buffer, vma_allocation);
+
+        vk_buffer = nullptr;
+        vma_allocation = nullptr;
+        mapped_data = nullptr;
+    }
+
+    dirty_ranges.clear();
+}
+
+//
+// Mapping
+//
+void *VulkanBuffer::map(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (memory_usage == MemoryUsage::GPUOnly) {
+        throw std::runtime_error("GPUOnly buffers can't be mapped! Upload to them instead!");
+    }
+
+    if (mapped_data != nullptr) {
+        return mapped_data;
+    }
+
+    VkResult result = vmaMapMemory(vulkan_instance->get_vma_allocator(), vma_allocation, &mapped_data);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vmaMapMemory failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vmaMapMemory failed! Please check the log above for more info!");
+    }
+
+    return mapped_data;
+}
+
+void VulkanBuffer::unmap(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    // Persistent mappings live as long as the buffer does
+    if (persistent_map || mapped_data == nullptr) {
+        return;
+    }
+
+    flush(vulkan_instance);
+
+    vmaUnmapMemory(vulkan_instance->get_vma_allocator(), vma_allocation);
+    mapped_data = nullptr;
+}
+
+void VulkanBuffer::write(const void *data, VkDeviceSize size, VkDeviceSize offset) {
+    if (mapped_data == nullptr) {
+        throw std::runtime_error("Buffer isn't mapped! Call map() first or create it with persistent_map!");
+    }
+
+    if (offset + size > this->size) {
+        throw std::runtime_error("Write is out of the buffer's bounds!");
+    }
+
+    std::memcpy(static_cast<uint8_t*>(mapped_data) + offset, data, size);
+    mark_dirty(offset, size);
+}
+
+void VulkanBuffer::mark_dirty(VkDeviceSize offset, VkDeviceSize size) {
+    if (coherent) {
+        return;
+    }
+
+    dirty_ranges.push_back({offset, size});
+}
+
+void VulkanBuffer::flush(VulkanInstance *vulkan_instance) {
+    if (dirty_ranges.empty()) {
+        return;
+    }
+
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    std::sort(dirty_ranges.begin(), dirty_ranges.end(), [](const DirtyRange &a, const DirtyRange &b) {
+        return a.offset < b.offset;
+    });
+
+    flush_allocations.clear();
+    flush_offsets.clear();
+    flush_sizes.clear();
+
+    // VMA rounds every range out to nonCoherentAtomSize for us
+    for (const auto &range : dirty_ranges) {
+        if (!flush_offsets.empty() && range.offset <= flush_offsets.back() + flush_sizes.back()) {
+            VkDeviceSize end = std::max(flush_offsets.back() + flush_sizes.back(), range.offset + range.size);
+            flush_sizes.back() = end - flush_offsets.back();
+            continue;
+        }
+
+        flush_allocations.push_back(vma_allocation);
+        flush_offsets.push_back(range.offset);
+        flush_sizes.push_back(range.size);
+    }
+
+    VkResult result = vmaFlushAllocations(
+        vulkan_instance->get_vma_allocator(),
+        static_cast<uint32_t>(flush_allocations.size()),
+        flush_allocations.data(),
+        flush_offsets.data(),
+        flush_sizes.data()
+    );
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vmaFlushAllocations failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vmaFlushAllocations failed! Please check the log above for more info!");
+    }
+
+    dirty_ranges.clear();
+}
+
+void VulkanBuffer::invalidate(VulkanInstance *vulkan_instance, VkDeviceSize offset, VkDeviceSize size) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (coherent) {
+        return;
+    }
+
+    VkResult result = vmaInvalidateAllocation(vulkan_instance->get_vma_allocator(), vma_allocation, offset, size);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vmaInvalidateAllocation failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vmaInvalidateAllocation failed! Please check the log above for more info!");
+    }
+}
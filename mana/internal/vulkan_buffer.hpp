@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_BUFFER_HPP
+#define MANA_VULKAN_BUFFER_HPP
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanInstance;
+
+    // Memory placement is picked from how the buffer is used, VMA then finds the best heap for it
+    class VulkanBuffer {
+    public:
+        enum class MemoryUsage {
+            // Device local, only written through transfers (see VulkanUploadEngine)
+            GPUOnly,
+
+            // Written by the CPU, read by the GPU, e.g. per frame uniforms
+            // Ends up in device local host visible memory (ReBAR) when the driver exposes it
+            Stream,
+
+            // Written by the GPU, read back by the CPU
+            Readback
+        };
+
+        struct BufferSettings {
+            VkDeviceSize size = 0;
+            VkBufferUsageFlags vk_usage_flags = 0;
+            VkSharingMode vk_sharing_mode = VK_SHARING_MODE_EXCLUSIVE;
+
+            MemoryUsage memory_usage = MemoryUsage::GPUOnly;
+
+            // Host visible buffers stay mapped for their whole lifetime, otherwise use map() / unmap()
+            bool persistent_map = true;
+        };
+
+    protected:
+        VkBuffer vk_buffer = nullptr;
+        VmaAllocation vma_allocation = nullptr;
+
+        VkDeviceSize size = 0;
+        MemoryUsage memory_usage;
+
+        void *mapped_data = nullptr;
+        bool persistent_map = false;
+        bool coherent = false;
+
+        // Written ranges not yet flushed, only tracked for non-coherent memory
+        struct DirtyRange {
+            VkDeviceSize offset;
+            VkDeviceSize size;
+        };
+
+        std::vector<DirtyRange> dirty_ranges;
+
+        // Scratch space for vmaFlushAllocations, kept around so flushing doesn't allocate
+        std::vector<VmaAllocation> flush_allocations;
+        std::vector<VkDeviceSize> flush_offsets;
+        std::vector<VkDeviceSize> flush_sizes;
+
+    public:
+        VulkanBuffer(VulkanInstance *vulkan_instance, const BufferSettings& settings);
+
+        void release(VulkanInstance *vulkan_instance);
+
+        // Only needed when the buffer isn't persistently mapped
+        void *map(VulkanInstance *vulkan_instance);
+        void unmap(VulkanInstance *vulkan_instance);
+
+        // Copies into the mapped memory, the range is flushed by the next flush()
+        void write(const void *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        // Marks a range written through get_mapped_data() directly
+        void mark_dirty(VkDeviceSize offset, VkDeviceSize size);
+
+        // Flushes every dirty range in a single call, adjacent and overlapping ranges are merged first
+        // Does nothing for coherent memory
+        void flush(VulkanInstance *vulkan_instance);
+
+        // Makes GPU writes visible to the CPU, call before reading a readback buffer
+        void invalidate(VulkanInstance *vulkan_instance, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        VkBuffer get_vk_buffer() const {
+            return vk_buffer;
+        }
+
+        [[nodiscard]]
+        VkDeviceSize get_size() const {
+            return size;
+        }
+
+        [[nodiscard]]
+        MemoryUsage get_memory_usage() const {
+            return memory_usage;
+        }
+
+        // Null unless the buffer is host visible and mapped
+        [[nodiscard]]
+        void *get_mapped_data() const {
+            return mapped_data;
+        }
+
+        [[nodiscard]]
+        bool is_coherent() const {
+            return coherent;
+        }
+    };
+}
+
+#endif//MANA_VULKAN_BUFFER_HPP
@@ -49,33 +49,60 @@ VulkanCmdBuffer::VulkanCmdBuffer(const BufferConfig &config, VulkanQueue *owner)
 
     this->vk_cmd_buffer = config.vk_cmd_buffer;
     this->vk_flags = config.vk_flags;
+    this->vk_level = config.vk_level;
 }
 
-void VulkanCmdBuffer::begin(VulkanInstance *vulkan_instance) {
-    //
-    // Reset
-    //
-    VkResult result = vkResetCommandBuffer(vk_cmd_buffer, 0);
-
-    if (result != VK_SUCCESS) {
-        LOG("Error: vkResetCommandBuffer failed with error code (" << string_VkResult(result) << ")");
-        throw std::runtime_error("vkResetCommandBuffer failed! Please check the log above for more info!");
-    }
-
+void VulkanCmdBuffer::begin(VulkanInstance *vulkan_instance, const InheritanceInfo *inheritance) {
     //
     // Begin command
+    // There's no reset here, the owning VulkanCmdPool resets all of its buffers at once
     //
     if (vulkan_instance == nullptr) {
         throw std::runtime_error("vulkan_instance was nullptr!");
     }
 
+    if (vk_level == VK_COMMAND_BUFFER_LEVEL_SECONDARY && inheritance == nullptr) {
+        throw std::runtime_error("Secondary command buffers require inheritance info!");
+    }
+
+    VkCommandBufferInheritanceRenderingInfoKHR inheritance_rendering_info{};
+    if (inheritance != nullptr && inheritance->dynamic) {
+        inheritance_rendering_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        // Must be 0, the contents bit only belongs on the primary's vkCmdBeginRendering
+        inheritance_rendering_info.flags = 0;
+
+        inheritance_rendering_info.colorAttachmentCount = static_cast<uint32_t>(inheritance->vk_color_formats.size());
+        inheritance_rendering_info.pColorAttachmentFormats = inheritance->vk_color_formats.data();
+        inheritance_rendering_info.depthAttachmentFormat = inheritance->vk_depth_format;
+        inheritance_rendering_info.stencilAttachmentFormat = inheritance->vk_stencil_format;
+        inheritance_rendering_info.rasterizationSamples = inheritance->vk_samples;
+    }
+
+    VkCommandBufferInheritanceInfo inheritance_info{};
+    if (inheritance != nullptr) {
+        inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+        if (inheritance->dynamic) {
+            inheritance_info.pNext = &inheritance_rendering_info;
+        }
+
+        inheritance_info.renderPass = inheritance->vk_render_pass;
+        inheritance_info.subpass = inheritance->subpass;
+        inheritance_info.framebuffer = inheritance->vk_framebuffer;
+    }
+
     VkCommandBufferBeginInfo buffer_begin_info{};
     {
         buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         buffer_begin_info.flags = vk_flags;
+
+        if (inheritance != nullptr) {
+            buffer_begin_info.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            buffer_begin_info.pInheritanceInfo = &inheritance_info;
+        }
     }
 
-    result = vkBeginCommandBuffer(vk_cmd_buffer, &buffer_begin_info);
+    VkResult result = vkBeginCommandBuffer(vk_cmd_buffer, &buffer_begin_info);
 
     if (result != VK_SUCCESS) {
         LOG("Error: vkBeginCommandBuffer failed with error code (" << string_VkResult(result) << ")");
@@ -92,31 +119,15 @@ void VulkanCmdBuffer::end(VulkanInstance *vulkan_instance) {
     }
 }
 
-void VulkanCmdBuffer::submit(const SubmitInfo &info) {
-    // It's up the user to await their submitted semaphores
-    VkSubmitInfo submit_info{};
-    {
-        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-        submit_info.waitSemaphoreCount = info.vk_wait_semaphores.size();
-        submit_info.pWaitSemaphores = info.vk_wait_semaphores.data();
-        submit_info.pWaitDstStageMask = info.vk_wait_flags.data();
-
-        submit_info.signalSemaphoreCount = info.vk_signal_semaphores.size();
-        submit_info.pSignalSemaphores = info.vk_signal_semaphores.data();
-
-        submit_info.commandBufferCount = 1;
-        submit_info.pCommandBuffers = &vk_cmd_buffer;
-    }
-
-    VkResult result = vkQueueSubmit(owner->get_vk_queue(), 1, &submit_info, info.vk_fence);
-    if (result != VK_SUCCESS) {
-        LOG("Error: vkQueueSubmit failed with error code (" << string_VkResult(result) << ")");
-        throw std::runtime_error("vkQueueSubmit failed! Please check the log above for more info!");
-    }
+VulkanScheduler::TimelinePoint VulkanCmdBuffer::submit(const SubmitInfo &info) {
+    // Only batched here, the queue sends it to the GPU on its next flush
+    return owner->enqueue_submit(vk_cmd_buffer, info);
 }
 
-void VulkanCmdBuffer::present(const PresentInfo &info) {
+VkResult VulkanCmdBuffer::present(const PresentInfo &info) {
+    // The semaphore we wait on is signaled by our queue, so that submission has to reach the GPU first
+    owner->flush_submits();
+
     VkPresentInfoKHR present_info{};
     {
         present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -129,5 +140,12 @@ void VulkanCmdBuffer::present(const PresentInfo &info) {
         present_info.pImageIndices = &info.frame_index;
     }
 
-    vkQueuePresentKHR(info.vulkan_queue_present->get_vk_queue(), &present_info);
+    VkResult result = info.vulkan_queue_present->present(present_info);
+
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR && result != VK_ERROR_OUT_OF_DATE_KHR) {
+        LOG("Error: vkQueuePresentKHR failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkQueuePresentKHR failed! Please check the log above for more info!");
+    }
+
+    return result;
 }
@@ -27,27 +27,51 @@ SOFTWARE.
 
 #include <vulkan/vulkan.h>
 
-#include <vector>
+#include <mana/internal/vulkan_scheduler.hpp>
+#include <mana/internal/fixed_vector.hpp>
 
 namespace ManaVK::Internal {
     class VulkanInstance;
     class VulkanQueue;
 
+    // Always owned by a VulkanCmdPool, which is also responsible for resetting it
     class VulkanCmdBuffer {
     public:
         struct BufferConfig {
             VkCommandBuffer vk_cmd_buffer = nullptr;
             VkCommandBufferUsageFlags vk_flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            VkCommandBufferLevel vk_level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         };
 
+        // Secondary buffers recorded inside a render pass need to know which pass they continue
+        struct InheritanceInfo {
+            VkRenderPass vk_render_pass = nullptr;
+            uint32_t subpass = 0;
+
+            // Optional, but may let the driver optimize the secondary buffer
+            VkFramebuffer vk_framebuffer = nullptr;
+
+            // Dynamic passes have no VkRenderPass, the attachment formats are inherited instead
+            bool dynamic = false;
+            FixedVector<VkFormat, 8> vk_color_formats;
+            VkFormat vk_depth_format = VK_FORMAT_UNDEFINED;
+            VkFormat vk_stencil_format = VK_FORMAT_UNDEFINED;
+            VkSampleCountFlagBits vk_samples = VK_SAMPLE_COUNT_1_BIT;
+        };
+
+        // Submissions always signal the owning queue's timeline, see VulkanScheduler
         struct SubmitInfo {
-            VkFence vk_fence;
-            std::vector<VkSemaphore> vk_wait_semaphores;
-            std::vector<VkSemaphore> vk_signal_semaphores;
+            // Binary semaphores, these are only needed for swapchain interaction
+            // Submitted every frame, so these are inline to keep the heap out of it
+            FixedVector<VkSemaphore, 4> vk_wait_semaphores;
+            FixedVector<VkSemaphore, 4> vk_signal_semaphores;
 
-            std::vector<VkPipelineStageFlags> vk_wait_flags {
+            FixedVector<VkPipelineStageFlags, 4> vk_wait_flags {
                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
             };
+
+            // Work on this or other queues that must finish first
+            FixedVector<VulkanScheduler::TimelineWait, 8> timeline_waits;
         };
 
         struct PresentInfo {
@@ -62,15 +86,20 @@ namespace ManaVK::Internal {
         VulkanQueue *owner = nullptr;
         VkCommandBuffer vk_cmd_buffer = nullptr;
         VkCommandBufferUsageFlags vk_flags;
+        VkCommandBufferLevel vk_level;
 
     public:
         VulkanCmdBuffer(const BufferConfig &config, VulkanQueue *owner);
 
-        void begin(VulkanInstance *vulkan_instance);
+        // Secondary buffers must provide inheritance info
+        void begin(VulkanInstance *vulkan_instance, const InheritanceInfo *inheritance = nullptr);
         void end(VulkanInstance *vulkan_instance);
 
-        void submit(const SubmitInfo &info);
-        void present(const PresentInfo &info);
+        // Returns the timeline point that is reached once this buffer has executed
+        // The submission is batched by the owning queue, see VulkanQueue::flush_submits()
+        VulkanScheduler::TimelinePoint submit(const SubmitInfo &info);
+        // OUT_OF_DATE and SUBOPTIMAL are returned to the caller, any other failure throws
+        VkResult present(const PresentInfo &info);
 
         //
         // Getters
@@ -79,6 +108,16 @@ namespace ManaVK::Internal {
         VkCommandBuffer get_vk_cmd_buffer() const {
             return vk_cmd_buffer;
         }
+
+        [[nodiscard]]
+        VulkanQueue *get_owner() const {
+            return owner;
+        }
+
+        [[nodiscard]]
+        VkCommandBufferLevel get_vk_level() const {
+            return vk_level;
+        }
     };
 }
 
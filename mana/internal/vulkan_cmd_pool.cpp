@@ -0,0 +1,171 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_cmd_pool.hpp"
+
+#include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_queue.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <stdexcept>
+#include <iostream>
+
+using namespace ManaVK::Internal;
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanCmdPool]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+VulkanCmdPool::VulkanCmdPool(VkDevice vk_device, VulkanQueue *owner, const PoolConfig &config)
+    : owner(owner)
+{
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    if (owner == nullptr) {
+        throw std::runtime_error("owner was nullptr!");
+    }
+
+    if (config.batch_size == 0) {
+        throw std::runtime_error("batch_size was 0!");
+    }
+
+    this->vk_level = config.vk_level;
+    this->batch_size = config.batch_size;
+
+    VkCommandPoolCreateInfo pool_create_info{};
+    {
+        pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+
+        pool_create_info.flags = config.vk_flags;
+        pool_create_info.queueFamilyIndex = owner->get_index();
+    }
+
+    VkResult result = vkCreateCommandPool(vk_device, &pool_create_info, nullptr, &vk_cmd_pool);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkCreateCommandPool failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreateCommandPool failed! Please check the log above for more info!");
+    }
+}
+
+VulkanCmdPool::~VulkanCmdPool() {
+    if (vk_cmd_pool != nullptr) {
+        LOG("Warning: VulkanCmdPool was destroyed without calling release(), the VkCommandPool has leaked!");
+    }
+}
+
+void VulkanCmdPool::allocate_batch(VkDevice vk_device) {
+    std::vector<VkCommandBuffer> vk_buffers(batch_size);
+
+    VkCommandBufferAllocateInfo alloc_info{};
+    {
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+
+        alloc_info.commandPool = vk_cmd_pool;
+        alloc_info.commandBufferCount = batch_size;
+
+        alloc_info.level = vk_level;
+    }
+
+    VkResult result = vkAllocateCommandBuffers(vk_device, &alloc_info, vk_buffers.data());
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkAllocateCommandBuffers failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkAllocateCommandBuffers failed! Please check the log above for more info!");
+    }
+
+    for (auto vk_buffer : vk_buffers) {
+        VulkanCmdBuffer::BufferConfig config;
+        {
+            config.vk_cmd_buffer = vk_buffer;
+            config.vk_level = vk_level;
+        }
+
+        vulkan_cmd_buffers.emplace_back(std::make_unique<VulkanCmdBuffer>(config, owner));
+        free_buffers.push_back(vulkan_cmd_buffers.back().get());
+    }
+}
+
+VulkanCmdBuffer *VulkanCmdPool::next_cmd_buffer(VkDevice vk_device) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    if (vk_cmd_pool == nullptr) {
+        throw std::runtime_error("vk_cmd_pool was nullptr! Was the pool released?");
+    }
+
+    if (free_buffers.empty()) {
+        allocate_batch(vk_device);
+    }
+
+    VulkanCmdBuffer *buffer = free_buffers.back();
+    free_buffers.pop_back();
+
+    used_buffers.push_back(buffer);
+    return buffer;
+}
+
+void VulkanCmdPool::reset(VkDevice vk_device) {
+    if (used_buffers.empty()) {
+        return;
+    }
+
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    VkResult result = vkResetCommandPool(vk_device, vk_cmd_pool, 0);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkResetCommandPool failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkResetCommandPool failed! Please check the log above for more info!");
+    }
+
+    // Pushed in reverse so buffers come back out in the order they were first handed out
+    for (auto iter = used_buffers.rbegin(); iter != used_buffers.rend(); iter++) {
+        free_buffers.push_back(*iter);
+    }
+
+    used_buffers.clear();
+}
+
+void VulkanCmdPool::release(VkDevice vk_device) {
+    if (vk_cmd_pool != nullptr) {
+        if (vk_device == nullptr) {
+            throw std::runtime_error("vk_device was nullptr!");
+        }
+
+        // Destroying the pool frees every buffer allocated from it
+        vkDestroyCommandPool(vk_device, vk_cmd_pool, nullptr);
+
+        vk_cmd_pool = nullptr;
+
+        free_buffers.clear();
+        used_buffers.clear();
+        vulkan_cmd_buffers.clear();
+    }
+}
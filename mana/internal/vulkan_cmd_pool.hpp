@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_CMD_POOL_HPP
+#define MANA_VULKAN_CMD_POOL_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanCmdBuffer;
+    class VulkanQueue;
+
+    // A command pool that owns every buffer allocated from it
+    // Vulkan pools aren't thread safe, so each recording thread gets its own pool (per frame slot)
+    //
+    // Buffers are never reset individually, the whole pool is reset at once when its frame slot comes around again
+    // Most drivers can then recycle the pool memory wholesale instead of walking every buffer
+    // Reset buffers go onto a free list, and new ones are allocated in batches when it runs dry
+    class VulkanCmdPool {
+    public:
+        struct PoolConfig {
+            VkCommandBufferLevel vk_level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+            // Buffers only live for a single frame, so the pool is transient and never resets single buffers
+            VkCommandPoolCreateFlags vk_flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+            // How many buffers are allocated at once when the free list is empty
+            uint32_t batch_size = 4;
+        };
+
+    protected:
+        VulkanQueue *owner = nullptr;
+        VkCommandPool vk_cmd_pool = nullptr;
+        VkCommandBufferLevel vk_level;
+        uint32_t batch_size;
+
+        std::vector<std::unique_ptr<VulkanCmdBuffer>> vulkan_cmd_buffers;
+
+        std::vector<VulkanCmdBuffer*> free_buffers;
+        std::vector<VulkanCmdBuffer*> used_buffers;
+
+        void allocate_batch(VkDevice vk_device);
+
+    public:
+        VulkanCmdPool(VkDevice vk_device, VulkanQueue *owner, const PoolConfig &config);
+        ~VulkanCmdPool();
+
+        // Hands out a buffer ready to begin, it stays owned by the pool and is valid until the next reset()
+        VulkanCmdBuffer *next_cmd_buffer(VkDevice vk_device);
+
+        // Resets the whole pool and returns every handed out buffer to the free list
+        // Only call once the GPU is done with all of them!
+        void reset(VkDevice vk_device);
+
+        void release(VkDevice vk_device);
+
+    public:
+        [[nodiscard]]
+        VkCommandPool get_vk_cmd_pool() const {
+            return vk_cmd_pool;
+        }
+
+        [[nodiscard]]
+        VkCommandBufferLevel get_vk_level() const {
+            return vk_level;
+        }
+
+        [[nodiscard]]
+        size_t get_used_count() const {
+            return used_buffers.size();
+        }
+
+        [[nodiscard]]
+        size_t get_allocated_count() const {
+            return vulkan_cmd_buffers.size();
+        }
+    };
+}
+
+#endif//MANA_VULKAN_CMD_POOL_HPP
@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_frame_arena.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace ManaVK::Internal;
+
+VulkanFrameArena::VulkanFrameArena(size_t block_size) {
+    if (block_size == 0) {
+        throw std::runtime_error("block_size was 0!");
+    }
+
+    this->block_size = block_size;
+}
+
+void *VulkanFrameArena::allocate_bytes(size_t size, size_t alignment) {
+    while (true) {
+        if (block_index < blocks.size()) {
+            Block &block = blocks[block_index];
+
+            size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+
+            if (aligned + size <= block.size) {
+                offset = aligned + size;
+                return block.data.get() + aligned;
+            }
+
+            // Doesn't fit, move onto the next block (or create one below)
+            block_index++;
+            offset = 0;
+
+            continue;
+        }
+
+        // Oversized requests get a block of their own
+        Block block;
+        {
+            block.size = std::max(block_size, size + alignment);
+            block.data = std::make_unique<unsigned char[]>(block.size);
+        }
+
+        blocks.emplace_back(std::move(block));
+    }
+}
+
+void VulkanFrameArena::reset() {
+    block_index = 0;
+    offset = 0;
+}
@@ -0,0 +1,89 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_FRAME_ARENA_HPP
+#define MANA_VULKAN_FRAME_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace ManaVK::Internal {
+    // A linear allocator for CPU side scratch data that only lives for a single frame
+    // Each frame slot owns one, it's reset once the slot comes around again
+    //
+    // Running out of space adds another block instead of failing, and blocks are kept across resets
+    // So once a frame has warmed up, the arena never touches the heap again
+    class VulkanFrameArena {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+    protected:
+        struct Block {
+            std::unique_ptr<unsigned char[]> data;
+            size_t size = 0;
+        };
+
+        std::vector<Block> blocks;
+        size_t block_size;
+
+        size_t block_index = 0;
+        size_t offset = 0;
+
+        void *allocate_bytes(size_t size, size_t alignment);
+
+    public:
+        explicit VulkanFrameArena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        // Objects are never destroyed, so only trivially destructible types are allowed
+        template<typename T>
+        T *allocate(size_t count) {
+            static_assert(std::is_trivially_destructible_v<T>, "VulkanFrameArena can only hold trivially destructible types!");
+
+            if (count == 0) {
+                return nullptr;
+            }
+
+            T *items = static_cast<T*>(allocate_bytes(sizeof(T) * count, alignof(T)));
+
+            for (size_t i = 0; i < count; i++) {
+                new (items + i) T();
+            }
+
+            return items;
+        }
+
+        // Everything allocated before this is invalid afterwards!
+        void reset();
+
+        [[nodiscard]]
+        size_t get_block_count() const {
+            return blocks.size();
+        }
+    };
+}
+
+#endif//MANA_VULKAN_FRAME_ARENA_HPP
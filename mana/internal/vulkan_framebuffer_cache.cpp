@@ -0,0 +1,278 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_framebuffer_cache.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+using namespace ManaVK::Internal;
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanFramebufferCache]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+VulkanFramebufferCache::PassId VulkanFramebufferCache::get_pass_id(const VulkanRenderPass *vulkan_render_pass) {
+    PassId pass_id;
+
+    if (vulkan_render_pass->get_compatibility_id() != UINT32_MAX) {
+        pass_id.cached = true;
+        pass_id.id = vulkan_render_pass->get_compatibility_id();
+    } else {
+        pass_id.id = reinterpret_cast<uint64_t>(vulkan_render_pass->get_vk_render_pass());
+    }
+
+    return pass_id;
+}
+
+bool VulkanFramebufferCache::matches(const Entry &entry, const PassId &pass_id, const FramebufferKey &key) {
+    const FramebufferKey &other = entry.key;
+
+    if (!(entry.pass_id == pass_id) || other.imageless != key.imageless || other.layers != key.layers) {
+        return false;
+    }
+
+    if (other.vk_extent.width != key.vk_extent.width || other.vk_extent.height != key.vk_extent.height) {
+        return false;
+    }
+
+    if (key.imageless) {
+        if (other.attachments.size() != key.attachments.size()) {
+            return false;
+        }
+
+        for (size_t a = 0; a < key.attachments.size(); a++) {
+            const AttachmentDesc &lhs = other.attachments[a];
+            const AttachmentDesc &rhs = key.attachments[a];
+
+            if (lhs.vk_format != rhs.vk_format || lhs.vk_usage_flags != rhs.vk_usage_flags || lhs.vk_create_flags != rhs.vk_create_flags) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    return std::equal(other.vk_views.begin(), other.vk_views.end(), key.vk_views.begin(), key.vk_views.end());
+}
+
+VkFramebuffer VulkanFramebufferCache::create(VkDevice vk_device, const FramebufferKey &key) {
+    FixedVector<VkFramebufferAttachmentImageInfo, VulkanRenderPass::MAX_ATTACHMENTS> vk_image_infos;
+
+    for (const auto &attachment : key.attachments) {
+        VkFramebufferAttachmentImageInfo vk_image_info {};
+        {
+            vk_image_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO;
+
+            vk_image_info.flags = attachment.vk_create_flags;
+            vk_image_info.usage = attachment.vk_usage_flags;
+
+            vk_image_info.width = key.vk_extent.width;
+            vk_image_info.height = key.vk_extent.height;
+            vk_image_info.layerCount = key.layers;
+
+            vk_image_info.viewFormatCount = 1;
+            vk_image_info.pViewFormats = &attachment.vk_format;
+        }
+
+        vk_image_infos.push_back(vk_image_info);
+    }
+
+    VkFramebufferAttachmentsCreateInfo attachments_create_info {};
+    {
+        attachments_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO;
+
+        attachments_create_info.attachmentImageInfoCount = static_cast<uint32_t>(vk_image_infos.size());
+        attachments_create_info.pAttachmentImageInfos = vk_image_infos.data();
+    }
+
+    VkFramebufferCreateInfo framebuffer_create_info {};
+    {
+        framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+
+        framebuffer_create_info.renderPass = key.vulkan_render_pass->get_vk_render_pass();
+
+        if (key.imageless) {
+            framebuffer_create_info.pNext = &attachments_create_info;
+            framebuffer_create_info.flags = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT;
+            framebuffer_create_info.attachmentCount = static_cast<uint32_t>(key.attachments.size());
+        } else {
+            framebuffer_create_info.attachmentCount = static_cast<uint32_t>(key.vk_views.size());
+            framebuffer_create_info.pAttachments = key.vk_views.data();
+        }
+
+        framebuffer_create_info.width = key.vk_extent.width;
+        framebuffer_create_info.height = key.vk_extent.height;
+
+        framebuffer_create_info.layers = key.layers;
+    }
+
+    VkFramebuffer vk_framebuffer = nullptr;
+    VkResult result = vkCreateFramebuffer(vk_device, &framebuffer_create_info, nullptr, &vk_framebuffer);
+
+    if (result != VK_SUCCESS) {
+        LOG("vkCreateFramebuffer failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreateFramebuffer failed! Please check the log above for more info!");
+    }
+
+    return vk_framebuffer;
+}
+
+VkFramebuffer VulkanFramebufferCache::get(VkDevice vk_device, const FramebufferKey &key) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    if (key.vulkan_render_pass == nullptr) {
+        throw std::runtime_error("vulkan_render_pass was nullptr! You can't create a framebuffer without a render pass!");
+    }
+
+    PassId pass_id = get_pass_id(key.vulkan_render_pass);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &entry : entries) {
+        if (matches(entry, pass_id, key)) {
+            if (key.imageless) {
+                entry.references++;
+            }
+
+            return entry.vk_framebuffer;
+        }
+    }
+
+    Entry entry;
+    {
+        entry.pass_id = pass_id;
+        entry.key = key;
+        entry.vk_framebuffer = create(vk_device, key);
+        entry.references = key.imageless ? 1 : 0;
+    }
+
+    entries.push_back(entry);
+    return entry.vk_framebuffer;
+}
+
+void VulkanFramebufferCache::evict_views(VkDevice vk_device, const VkImageView *vk_views, size_t count) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto uses_view = [vk_views, count](const Entry &entry) {
+        for (auto vk_view : entry.key.vk_views) {
+            if (std::find(vk_views, vk_views + count, vk_view) != vk_views + count) {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    for (auto &entry : entries) {
+        if (uses_view(entry)) {
+            vkDestroyFramebuffer(vk_device, entry.vk_framebuffer, nullptr);
+            entry.vk_framebuffer = nullptr;
+        }
+    }
+
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry &entry) {
+        return entry.vk_framebuffer == nullptr;
+    }), entries.end());
+}
+
+void VulkanFramebufferCache::evict_pass(VkDevice vk_device, const VulkanRenderPass *vulkan_render_pass) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    if (vulkan_render_pass == nullptr || vulkan_render_pass->get_vk_render_pass() == nullptr) {
+        return;
+    }
+
+    PassId pass_id = get_pass_id(vulkan_render_pass);
+
+    if (pass_id.cached) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &entry : entries) {
+        if (entry.pass_id == pass_id) {
+            vkDestroyFramebuffer(vk_device, entry.vk_framebuffer, nullptr);
+            entry.vk_framebuffer = nullptr;
+        }
+    }
+
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry &entry) {
+        return entry.vk_framebuffer == nullptr;
+    }), entries.end());
+}
+
+void VulkanFramebufferCache::release_imageless(VkDevice vk_device, VkFramebuffer vk_framebuffer) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    if (vk_framebuffer == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto iter = std::find_if(entries.begin(), entries.end(), [vk_framebuffer](const Entry &entry) {
+        return entry.key.imageless && entry.vk_framebuffer == vk_framebuffer;
+    });
+
+    // Already gone if its pass was evicted
+    if (iter == entries.end()) {
+        return;
+    }
+
+    if (iter->references > 1) {
+        iter->references--;
+        return;
+    }
+
+    vkDestroyFramebuffer(vk_device, iter->vk_framebuffer, nullptr);
+    entries.erase(iter);
+}
+
+void VulkanFramebufferCache::release(VkDevice vk_device) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &entry : entries) {
+        vkDestroyFramebuffer(vk_device, entry.vk_framebuffer, nullptr);
+    }
+
+    entries.clear();
+}
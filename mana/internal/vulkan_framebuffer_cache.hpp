@@ -0,0 +1,120 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_FRAMEBUFFER_CACHE_HPP
+#define MANA_VULKAN_FRAMEBUFFER_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mana/internal/fixed_vector.hpp>
+#include <mana/internal/vulkan_render_pass.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ManaVK::Internal {
+    // Device wide, framebuffers are shared between every render pass of the same compatibility class
+    //
+    // Regular framebuffers are keyed by their views, so they have to be evicted when a view is destroyed
+    // Imageless framebuffers (core in 1.2) only describe their attachments, one serves every swapchain image
+    // and survives a recreate that keeps the extent, it's reference counted and destroyed with its last user
+    class VulkanFramebufferCache {
+    public:
+        // What an imageless framebuffer's attachment must look like, must match the image exactly
+        struct AttachmentDesc {
+            VkFormat vk_format = VK_FORMAT_UNDEFINED;
+            VkImageUsageFlags vk_usage_flags = 0;
+            VkImageCreateFlags vk_create_flags = 0;
+        };
+
+        struct FramebufferKey {
+            // Used to create the framebuffer, compatible passes share the result
+            VulkanRenderPass *vulkan_render_pass = nullptr;
+
+            VkExtent2D vk_extent {};
+            uint32_t layers = 1;
+
+            // Set for regular framebuffers
+            FixedVector<VkImageView, VulkanRenderPass::MAX_ATTACHMENTS> vk_views;
+
+            // Set for imageless framebuffers
+            FixedVector<AttachmentDesc, VulkanRenderPass::MAX_ATTACHMENTS> attachments;
+            bool imageless = false;
+        };
+
+    protected:
+        // Cached passes are identified by their compatibility class, uncached ones by their VkRenderPass handle
+        // The two are tagged apart, a handle can be any value (non-dispatchable handles may be small integers)
+        struct PassId {
+            bool cached = false;
+            uint64_t id = 0;
+
+            bool operator==(const PassId &other) const {
+                return cached == other.cached && id == other.id;
+            }
+        };
+
+        struct Entry {
+            PassId pass_id;
+
+            FramebufferKey key;
+            VkFramebuffer vk_framebuffer = nullptr;
+
+            // Imageless only, one per get() not yet matched by a release_imageless()
+            uint32_t references = 0;
+        };
+
+        std::mutex mutex;
+
+        // Few enough that a linear search beats hashing the key
+        std::vector<Entry> entries;
+
+        static PassId get_pass_id(const VulkanRenderPass *vulkan_render_pass);
+        static bool matches(const Entry &entry, const PassId &pass_id, const FramebufferKey &key);
+
+        static VkFramebuffer create(VkDevice vk_device, const FramebufferKey &key);
+
+    public:
+        // Thread safe, creates the framebuffer on first use
+        // Imageless framebuffers are referenced by every get(), each must be paired with a release_imageless()
+        VkFramebuffer get(VkDevice vk_device, const FramebufferKey &key);
+
+        // Destroys every framebuffer using one of the views, the GPU must be done with them
+        void evict_views(VkDevice vk_device, const VkImageView *vk_views, size_t count);
+
+        // Destroys every framebuffer made for an uncached pass, call before the pass is destroyed
+        // Its handle could be reused by a new pass otherwise, which would then be handed stale framebuffers
+        // Cached passes are left alone, their framebuffers belong to the compatibility class
+        void evict_pass(VkDevice vk_device, const VulkanRenderPass *vulkan_render_pass);
+
+        // Drops a reference taken by get(), the framebuffer is destroyed along with the last one
+        // Imageless framebuffers have no views to be evicted by, the GPU must be done with this user's work
+        void release_imageless(VkDevice vk_device, VkFramebuffer vk_framebuffer);
+
+        void release(VkDevice vk_device);
+    };
+}
+
+#endif//MANA_VULKAN_FRAMEBUFFER_CACHE_HPP
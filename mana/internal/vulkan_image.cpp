@@ -38,43 +38,27 @@ SOFTWARE.
 
 using namespace ManaVK::Internal;
 
-VulkanImage::VulkanImage(VulkanInstance *vulkan_instance, const ImageSettings &settings) {
-    if (vulkan_instance == nullptr) {
-        throw std::runtime_error("vulkan_instance was nullptr!");
-    }
-
+VkImageCreateInfo VulkanImage::make_image_info(const ImageSettings &settings) {
     //
     // Enum translation
     //
-    uint32_t layer_count = settings.array_size;
     VkImageType vk_image_type = VK_IMAGE_TYPE_2D;
     VkImageCreateFlags vk_image_flags = 0;
-    VkImageViewType vk_view_type = VK_IMAGE_VIEW_TYPE_2D;
     switch (settings.shape) {
         case ImageShape::Shape1D:
-            if (settings.array_size > 1) {
-                vk_view_type = VK_IMAGE_VIEW_TYPE_1D_ARRAY;
-            }
-
             vk_image_type = VK_IMAGE_TYPE_1D;
             break;
 
         case ImageShape::Shape2D:
-            if (settings.array_size > 1) {
-                vk_view_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
-            }
-
             break;
 
         case ImageShape::Shape3D:
             vk_image_type = VK_IMAGE_TYPE_3D;
-            vk_view_type = VK_IMAGE_VIEW_TYPE_3D;
             break;
 
         case ImageShape::ShapeCube:
             vk_image_type = VK_IMAGE_TYPE_2D;
             vk_image_flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-            vk_view_type = VK_IMAGE_VIEW_TYPE_CUBE;
             break;
     }
 
@@ -82,16 +66,30 @@ VulkanImage::VulkanImage(VulkanInstance *vulkan_instance, const ImageSettings &s
     // Mip determining
     //
     uint32_t mip_levels = 1;
+    VkImageUsageFlags vk_usage_flags = settings.vk_usage_flags;
 
     if (settings.generate_mipmaps) {
         // Taken from the Vulkan Tutorial: https://vulkan-tutorial.com/Generating_Mipmaps
         mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(settings.vk_extent.width, settings.vk_extent.height)))) + 1;
+
+        // Every level is blitted from the one above it
+        vk_usage_flags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
     }
 
+    if (settings.transient) {
+        // Transient attachments are never copied to or from, so they can't have mips either
+        if (settings.generate_mipmaps) {
+            throw std::runtime_error("Transient images can't have mipmaps!");
+        }
+
+        // Lazily allocated memory can't be shared with anything else
+        if (settings.vma_alias_allocation != nullptr) {
+            throw std::runtime_error("Transient images can't alias other images!");
+        }
+
+        vk_usage_flags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
 
-    //
-    // Image creation
-    //
     VkImageCreateInfo image_info {};
     {
         image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -100,7 +98,7 @@ VulkanImage::VulkanImage(VulkanInstance *vulkan_instance, const ImageSettings &s
         image_info.extent.height = settings.vk_extent.height;
         image_info.extent.depth = settings.vk_extent.depth;
 
-        image_info.arrayLayers = layer_count;
+        image_info.arrayLayers = settings.array_size;
         image_info.mipLevels = mip_levels;
 
         image_info.samples = settings.vk_samples;
@@ -112,29 +110,118 @@ VulkanImage::VulkanImage(VulkanInstance *vulkan_instance, const ImageSettings &s
         image_info.tiling = settings.vk_tiling;
         image_info.initialLayout = settings.vk_layout;
 
-        image_info.usage = settings.vk_usage_flags;
+        image_info.usage = vk_usage_flags;
         image_info.sharingMode = settings.vk_sharing_mode;
     }
 
-    VkResult result = vkCreateImage(vulkan_instance->get_vk_device(), &image_info, nullptr, &vk_image);
+    return image_info;
+}
+
+VkMemoryRequirements VulkanImage::get_memory_requirements(VulkanInstance *vulkan_instance, const ImageSettings &settings) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    VkImageCreateInfo image_info = make_image_info(settings);
+
+    // Unbound images are cheap, and this works on 1.2 unlike vkGetDeviceImageMemoryRequirements
+    VkImage vk_probe = nullptr;
+    VkResult result = vkCreateImage(vulkan_instance->get_vk_device(), &image_info, nullptr, &vk_probe);
+
     if (result != VK_SUCCESS) {
         LOG("vkCreateImage failed with error code (" << string_VkResult(result) << ")");
         throw std::runtime_error("vkCreateImage failed! Please check the log above for more info!");
     }
 
+    VkMemoryRequirements vk_requirements {};
+    vkGetImageMemoryRequirements(vulkan_instance->get_vk_device(), vk_probe, &vk_requirements);
+
+    vkDestroyImage(vulkan_instance->get_vk_device(), vk_probe, nullptr);
+
+    return vk_requirements;
+}
+
+VulkanImage::VulkanImage(VulkanInstance *vulkan_instance, const ImageSettings &settings) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    VkImageCreateInfo image_info = make_image_info(settings);
+
+    VkImageViewType vk_view_type = VK_IMAGE_VIEW_TYPE_2D;
+    switch (settings.shape) {
+        case ImageShape::Shape1D:
+            if (settings.array_size > 1) {
+                vk_view_type = VK_IMAGE_VIEW_TYPE_1D_ARRAY;
+            }
+
+            break;
+
+        case ImageShape::Shape2D:
+            if (settings.array_size > 1) {
+                vk_view_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+            }
+
+            break;
+
+        case ImageShape::Shape3D:
+            vk_view_type = VK_IMAGE_VIEW_TYPE_3D;
+            break;
+
+        case ImageShape::ShapeCube:
+            vk_view_type = VK_IMAGE_VIEW_TYPE_CUBE;
+            break;
+    }
+
+    uint32_t mip_levels = image_info.mipLevels;
+    uint32_t layer_count = image_info.arrayLayers;
+
+    this->vk_format = settings.vk_format;
+    this->vk_usage_flags = image_info.usage;
+    this->vk_extent = settings.vk_extent;
+    this->mip_levels = mip_levels;
+    this->layer_count = layer_count;
+
     //
-    // Memory allocation
+    // Image creation + memory allocation
     //
-    {
-        VkMemoryRequirements mem_requirements{};
-        vkGetImageMemoryRequirements(vulkan_instance->get_vk_device(), vk_image, &mem_requirements);
+    VkResult result;
+
+    if (settings.vma_alias_allocation != nullptr) {
+        result = vmaCreateAliasingImage(vulkan_instance->get_vma_allocator(), settings.vma_alias_allocation, &image_info, &vk_image);
+
+        if (result != VK_SUCCESS) {
+            LOG("vmaCreateAliasingImage failed with error code (" << string_VkResult(result) << ")");
+            throw std::runtime_error("vmaCreateAliasingImage failed! Please check the log above for more info!");
+        }
+
+        vma_allocation = settings.vma_alias_allocation;
+        aliased = true;
+    } else {
+        VmaAllocationCreateInfo vma_alloc_info {};
+        {
+            vma_alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
-        VmaAllocationCreateInfo vma_alloc_info{};
-        VmaAllocationInfo vma_allocation_info;
+            if (settings.transient) {
+                vma_alloc_info.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+            }
+        }
+
+        result = vmaCreateImage(vulkan_instance->get_vma_allocator(), &image_info, &vma_alloc_info, &vk_image, &vma_allocation, nullptr);
+
+        // Desktop GPUs usually have no lazily allocated memory, that's expected so it isn't logged
+        // Full screen attachments are big and never resized in place, so they get their own allocation instead
+        if (result != VK_SUCCESS && settings.transient) {
+            vma_alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            vma_alloc_info.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
 
-        vmaAllocateMemoryForImage(vulkan_instance->get_vma_allocator(), vk_image, &vma_alloc_info, &vma_allocation, &vma_allocation_info);
+            result = vmaCreateImage(vulkan_instance->get_vma_allocator(), &image_info, &vma_alloc_info, &vk_image, &vma_allocation, nullptr);
+        }
 
-        vmaBindImageMemory(vulkan_instance->get_vma_allocator(), vma_allocation, vk_image);
+        if (result != VK_SUCCESS) {
+            LOG("vmaCreateImage failed with error code (" << string_VkResult(result) << ")");
+            throw std::runtime_error("vmaCreateImage failed! Please check the log above for more info!");
+        }
     }
 
     //
@@ -169,18 +256,19 @@ void VulkanImage::release(VulkanInstance *vulkan_instance) {
         throw std::runtime_error("vulkan_instance was nullptr! Can't release Vulkan resources, this is a memory leak!");
     }
 
-    if (vk_image != nullptr) {
-        vkDestroyImage(vulkan_instance->get_vk_device(), vk_image, nullptr);
-        vk_image = nullptr;
-    }
-
     if (vk_view != nullptr) {
         vkDestroyImageView(vulkan_instance->get_vk_device(), vk_view, nullptr);
         vk_view = nullptr;
     }
 
-    if (vma_allocation != nullptr) {
-        vmaFreeMemory(vulkan_instance->get_vma_allocator(), vma_allocation);
+    if (vk_image != nullptr) {
+        if (aliased) {
+            vkDestroyImage(vulkan_instance->get_vk_device(), vk_image, nullptr);
+        } else {
+            vmaDestroyImage(vulkan_instance->get_vma_allocator(), vk_image, vma_allocation);
+        }
+
+        vk_image = nullptr;
         vma_allocation = nullptr;
     }
 }
@@ -55,7 +55,17 @@ namespace ManaVK::Internal {
             ImageShape shape = ImageShape::Shape2D;
             uint32_t array_size = 1;
 
+            // Attachments whose contents never leave a render pass, see VulkanRenderPass::is_attachment_transient()
+            // Lands in lazily allocated memory when the device has it (tilers), otherwise gets a dedicated allocation
+            bool transient = false;
+
+            // Allocates the full mip chain, the levels are filled on the GPU when mip 0 is uploaded
+            // See VulkanUploadEngine::ImageUpload::generate_mips
             bool generate_mipmaps = true;
+
+            // Places the image at the start of an existing allocation instead of allocating its own
+            // The allocation belongs to the caller and must outlive the image, see VulkanRenderGraph
+            VmaAllocation vma_alias_allocation = nullptr;
         };
 
     protected:
@@ -63,9 +73,23 @@ namespace ManaVK::Internal {
         VkImageView vk_view = nullptr;
         VmaAllocation vma_allocation = nullptr;
 
+        // Aliased images don't own their memory, only the VkImage is destroyed
+        bool aliased = false;
+
+        VkFormat vk_format;
+        VkImageUsageFlags vk_usage_flags = 0;
+        VkExtent3D vk_extent;
+        uint32_t mip_levels = 1;
+        uint32_t layer_count = 1;
+
+        static VkImageCreateInfo make_image_info(const ImageSettings& settings);
+
     public:
         VulkanImage(VulkanInstance *vulkan_instance, const ImageSettings& settings);
 
+        // What an image with these settings would need, without allocating anything
+        static VkMemoryRequirements get_memory_requirements(VulkanInstance *vulkan_instance, const ImageSettings& settings);
+
         void release(VulkanInstance *vulkan_instance);
 
         //
@@ -80,6 +104,32 @@ namespace ManaVK::Internal {
         VkImageView get_vk_view() const {
             return vk_view;
         }
+
+        [[nodiscard]]
+        VkFormat get_vk_format() const {
+            return vk_format;
+        }
+
+        // Everything the image was created with, including the flags added for mips and transient memory
+        [[nodiscard]]
+        VkImageUsageFlags get_vk_usage_flags() const {
+            return vk_usage_flags;
+        }
+
+        [[nodiscard]]
+        VkExtent3D get_vk_extent() const {
+            return vk_extent;
+        }
+
+        [[nodiscard]]
+        uint32_t get_mip_levels() const {
+            return mip_levels;
+        }
+
+        [[nodiscard]]
+        uint32_t get_layer_count() const {
+            return layer_count;
+        }
     };
 }
 
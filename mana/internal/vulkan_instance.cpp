@@ -31,12 +31,16 @@ SOFTWARE.
 
 #include <mana/internal/vulkan_render_pass.hpp>
 #include <mana/internal/vulkan_render_pass_builder.hpp>
+#include <mana/internal/vulkan_render_pass_cache.hpp>
+#include <mana/internal/vulkan_framebuffer_cache.hpp>
 #include <mana/internal/vulkan_queue.hpp>
+#include <mana/internal/vulkan_scheduler.hpp>
 #include <mana/internal/vulkan_window.hpp>
 
 using namespace ManaVK;
 using namespace ManaVK::Internal;
 
+#include <algorithm>
 #include <iostream>
 
 #define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanInstance]: "<< args
@@ -169,6 +173,28 @@ void VulkanInstance::init_find_gpu(const GPUPreferences &prefs) {
             LOG("============================");
         }
 
+        if (properties.apiVersion < prefs.min_api_version) {
+            LOG("Warning: GPU #" << gpu_number - 1 << " doesn't support the minimum required Vulkan version!");
+            continue;
+        }
+
+        // Timeline semaphores drive all of our frame scheduling, so they're not optional
+        {
+            VkPhysicalDeviceVulkan12Features features_12 {};
+            features_12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+            VkPhysicalDeviceFeatures2 features_2 {};
+            features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features_2.pNext = &features_12;
+
+            vkGetPhysicalDeviceFeatures2(gpu, &features_2);
+
+            if (!features_12.timelineSemaphore) {
+                LOG("Warning: GPU #" << gpu_number - 1 << " doesn't support timeline semaphores!");
+                continue;
+            }
+        }
+
         uint32_t queue_index = 0;
 
         std::vector<VulkanQueue::Type> requested_queues;
@@ -285,6 +311,53 @@ void VulkanInstance::init_find_gpu(const GPUPreferences &prefs) {
             }
         }
 
+        // Presenting from the graphics family uses the same VkQueue, so it's the same VulkanQueue too
+        // Otherwise presents and submits would touch one VkQueue under two different locks
+        if (queue_present != nullptr && queue_graphics != nullptr && queue_present->get_index() == queue_graphics->get_index() && queue_present->get_slot() == queue_graphics->get_slot()) {
+            delete queue_present;
+            queue_present = queue_graphics;
+        }
+
+        //
+        // Async compute
+        //
+        // Only a family without graphics support counts, otherwise compute simply shares the graphics queue
+        if (prefs.want_compute_queue) {
+            uint32_t family_index = 0;
+
+            for (VkQueueFamilyProperties queue_family: queue_families) {
+                bool is_compute = queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT;
+                bool is_graphics = queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT;
+
+                if (is_compute && !is_graphics) {
+                    bool shares_transfer = queue_transfer != nullptr && queue_transfer->get_index() == family_index;
+
+                    // Transfer often picks this same family, each VulkanQueue needs a VkQueue of its own
+                    // vkQueueSubmit on one VkQueue must be externally synchronized, and each VulkanQueue has its own lock
+                    if (!shares_transfer) {
+                        queue_compute = new VulkanQueue(VulkanQueue::Type::Compute, family_index);
+                    } else if (queue_family.queueCount > queue_transfer->get_slot() + 1) {
+                        queue_compute = new VulkanQueue(VulkanQueue::Type::Compute, family_index, queue_transfer->get_slot() + 1);
+                    } else {
+                        queue_compute = queue_transfer;
+                    }
+
+                    break;
+                }
+
+                family_index++;
+            }
+
+            if (queue_compute == nullptr) {
+                LOG("No dedicated compute family found, compute work will share the graphics queue");
+                queue_compute = queue_graphics;
+            } else if (queue_compute == queue_transfer) {
+                LOG("Queue family #" << queue_compute->get_index() << " only has one queue, async compute will share it with transfers");
+            } else {
+                LOG("Using queue family #" << queue_compute->get_index() << " (queue " << queue_compute->get_slot() << ") for async compute");
+            }
+        }
+
         return;
     }
 
@@ -303,26 +376,39 @@ void VulkanInstance::init_create_device(const VulkanInstance::DeviceSettings &se
         throw std::runtime_error("vk_gpu is nullptr! Have you called init_find_gpu()?");
     }
 
-    std::vector<VulkanQueue*> gpu_queues
-    {
-        queue_present,
-        queue_graphics,
-        queue_transfer
-    };
+    // Queues may alias each other (e.g. compute falling back to graphics), so only keep unique ones
+    std::vector<VulkanQueue*> gpu_queues;
 
-    float queue_priority = 1.0F;
+    for (auto queue : {queue_present, queue_graphics, queue_transfer, queue_compute}) {
+        if (queue != nullptr && std::find(gpu_queues.begin(), gpu_queues.end(), queue) == gpu_queues.end()) {
+            gpu_queues.push_back(queue);
+        }
+    }
+
+    // Enough for every queue taken from a single family
+    std::vector<float> queue_priorities(gpu_queues.size(), 1.0F);
     std::vector<VkDeviceQueueCreateInfo> device_queue_infos;
 
     for (const auto queue: gpu_queues) {
-        if (queue == nullptr) {
+        // Vulkan doesn't allow the same family to be listed twice, so families taking more queues ask for more
+        bool family_listed = false;
+
+        for (auto& listed : device_queue_infos) {
+            if (listed.queueFamilyIndex == queue->get_index()) {
+                listed.queueCount = std::max(listed.queueCount, queue->get_slot() + 1);
+                family_listed = true;
+            }
+        }
+
+        if (family_listed) {
             continue;
         }
 
         VkDeviceQueueCreateInfo queue_info{};
         queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queue_info.queueFamilyIndex = queue->get_index();
-        queue_info.queueCount = 1;
-        queue_info.pQueuePriorities = &queue_priority;
+        queue_info.queueCount = queue->get_slot() + 1;
+        queue_info.pQueuePriorities = queue_priorities.data();
 
         device_queue_infos.push_back(queue_info);
     }
@@ -344,9 +430,61 @@ void VulkanInstance::init_create_device(const VulkanInstance::DeviceSettings &se
         }
     }
 
+    // Optional 1.2 features, enabled when present
+    {
+        VkPhysicalDeviceVulkan12Features supported_12 {};
+        supported_12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features_2 {};
+        features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features_2.pNext = &supported_12;
+
+        vkGetPhysicalDeviceFeatures2(vk_gpu, &features_2);
+
+        imageless_framebuffer = supported_12.imagelessFramebuffer;
+    }
+
+    // Dynamic rendering is only used when the extension was asked for, it's core in 1.3 but we target 1.2
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR features_dynamic_rendering {};
+    {
+        features_dynamic_rendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+        for (const auto &extension: settings.extensions) {
+            if (extension.get_name() == VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) {
+                dynamic_rendering = true;
+            }
+        }
+
+        if (dynamic_rendering) {
+            VkPhysicalDeviceFeatures2 features_2 {};
+            features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features_2.pNext = &features_dynamic_rendering;
+
+            vkGetPhysicalDeviceFeatures2(vk_gpu, &features_2);
+
+            dynamic_rendering = features_dynamic_rendering.dynamicRendering;
+        }
+    }
+
+    VkPhysicalDeviceVulkan12Features features_12 {};
+    {
+        features_12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        // Required, see VulkanScheduler
+        features_12.timelineSemaphore = VK_TRUE;
+
+        // See VulkanFramebufferCache
+        features_12.imagelessFramebuffer = imageless_framebuffer;
+
+        if (dynamic_rendering) {
+            features_12.pNext = &features_dynamic_rendering;
+        }
+    }
+
     VkDeviceCreateInfo device_create_info{};
     {
         device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_create_info.pNext = &features_12;
 
         device_create_info.pQueueCreateInfos = device_queue_infos.data();
         device_create_info.queueCreateInfoCount = static_cast<uint32_t>(device_queue_infos.size());
@@ -373,6 +511,24 @@ void VulkanInstance::init_create_device(const VulkanInstance::DeviceSettings &se
         queue->warm_queue(vk_instance, vk_device);
     }
 
+    //
+    // Then the timelines every queue signals
+    //
+    scheduler = new VulkanScheduler(vk_device, gpu_queues);
+
+    if (dynamic_rendering) {
+        vk_cmd_begin_rendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(vkGetDeviceProcAddr(vk_device, "vkCmdBeginRenderingKHR"));
+        vk_cmd_end_rendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(vkGetDeviceProcAddr(vk_device, "vkCmdEndRenderingKHR"));
+
+        if (vk_cmd_begin_rendering == nullptr || vk_cmd_end_rendering == nullptr) {
+            LOG("Warning: VK_KHR_dynamic_rendering was enabled, but its functions couldn't be loaded!");
+            dynamic_rendering = false;
+        }
+    }
+
+    render_pass_cache = std::make_unique<VulkanRenderPassCache>();
+    framebuffer_cache = std::make_unique<VulkanFramebufferCache>();
+
     //
     // Create our VMA allocator
     //
@@ -448,18 +604,35 @@ void VulkanInstance::init_presentation(const VulkanInstance::PresentSettings &se
         config.vk_format_color = vulkan_color_format->get_vk_format();
         config.vk_color_space = vulkan_color_format->get_vk_color_space();
         config.vk_present_mode = vk_present_mode;
+        config.frames_in_flight = settings.frames_in_flight;
+        config.acquire_timeout = settings.acquire_timeout;
 
        if (vulkan_depth_format) {
            config.vk_format_depth = vulkan_depth_format->get_vk_format();
        }
 
-        config.vk_render_pass = settings.vulkan_render_pass->get_vk_render_pass();
+        config.vulkan_render_pass = settings.vulkan_render_pass.get();
+        config.depth_transient = settings.vulkan_render_pass->is_depth_transient();
 
         main_window->create_swapchain(this, config);
         main_window->create_command_objects(this, queue_graphics);
     }
 }
 
+//
+// Teardown
+//
+void VulkanInstance::release_caches() {
+    // Framebuffers first, they were created against the cached passes
+    if (framebuffer_cache != nullptr) {
+        framebuffer_cache->release(vk_device);
+    }
+
+    if (render_pass_cache != nullptr) {
+        render_pass_cache->release(vk_device);
+    }
+}
+
 //
 // Filtering
 //
@@ -28,6 +28,9 @@ SOFTWARE.
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 
+#include <mana/internal/vulkan_framebuffer_cache.hpp>
+#include <mana/internal/vulkan_render_pass_cache.hpp>
+
 #include <string>
 #include <vector>
 #include <functional>
@@ -38,6 +41,7 @@ namespace ManaVK::Internal {
     class VulkanWindow;
     class VulkanQueue;
     class VulkanRenderPass;
+    class VulkanScheduler;
 
     class VulkanInstance {
     protected:
@@ -168,6 +172,12 @@ namespace ManaVK::Internal {
             bool need_transfer_queue = true;
             bool need_present_queue = true;
 
+            // Optional, without a dedicated (async) compute family compute work shares the graphics queue
+            bool want_compute_queue = true;
+
+            // Timeline semaphores (and therefore frame scheduling) are core in Vulkan 1.2
+            uint32_t min_api_version = VK_API_VERSION_1_2;
+
             VkPhysicalDeviceFeatures required_features{};
         };
 
@@ -183,6 +193,12 @@ namespace ManaVK::Internal {
 
             std::vector<VkPresentModeKHR> vk_present_modes;
 
+            // How many frames the CPU may record before waiting on the GPU
+            uint32_t frames_in_flight = 2;
+
+            // Nanoseconds to wait for a swapchain image before giving up on the frame
+            uint64_t acquire_timeout = 100000000;
+
             // The user must create their own render pass at this point
             // This is because an engine might use either deferred or forward rendering!
             // Or some exotic pipelines like Forward+, Deferred+, etc...
@@ -229,6 +245,24 @@ namespace ManaVK::Internal {
         VulkanQueue* queue_transfer = nullptr;
         VulkanQueue* queue_present = nullptr;
 
+        // May be the same queue as queue_graphics, see has_async_compute()
+        VulkanQueue* queue_compute = nullptr;
+
+        VulkanScheduler *scheduler = nullptr;
+
+        // Shared by every VulkanRenderPassBuilder::build() that's handed it
+        // Released by ManaInstance once the device is idle, see release_caches()
+        std::unique_ptr<VulkanRenderPassCache> render_pass_cache = nullptr;
+        std::unique_ptr<VulkanFramebufferCache> framebuffer_cache = nullptr;
+
+        // Enabled whenever the device supports it, lets a single framebuffer serve every swapchain image
+        bool imageless_framebuffer = false;
+
+        // Enabled when VK_KHR_dynamic_rendering was requested and found, see VulkanRenderPass::is_dynamic()
+        bool dynamic_rendering = false;
+        PFN_vkCmdBeginRenderingKHR vk_cmd_begin_rendering = nullptr;
+        PFN_vkCmdEndRenderingKHR vk_cmd_end_rendering = nullptr;
+
         std::optional<VulkanSurfaceFormat> vulkan_color_format;
         std::optional<VulkanFormat> vulkan_depth_format;
         VkPresentModeKHR vk_present_mode = VK_PRESENT_MODE_MAX_ENUM_KHR;
@@ -243,6 +277,13 @@ namespace ManaVK::Internal {
         void init_create_device(const DeviceSettings& settings);
         void init_presentation(const PresentSettings& settings);
 
+        //
+        // Teardown
+        //
+
+        // Destroys every cached framebuffer and render pass, the device must be idle
+        void release_caches();
+
         //
         // Filtering functions
         //
@@ -295,6 +336,52 @@ namespace ManaVK::Internal {
         VulkanQueue *get_queue_transfer() const {
             return queue_transfer;
         }
+
+        [[nodiscard]]
+        VulkanQueue *get_queue_compute() const {
+            return queue_compute;
+        }
+
+        // True when compute work runs on its own queue family and can overlap graphics work
+        [[nodiscard]]
+        bool has_async_compute() const {
+            return queue_compute != nullptr && queue_compute != queue_graphics;
+        }
+
+        [[nodiscard]]
+        VulkanScheduler *get_scheduler() const {
+            return scheduler;
+        }
+
+        [[nodiscard]]
+        VulkanRenderPassCache *get_render_pass_cache() const {
+            return render_pass_cache.get();
+        }
+
+        [[nodiscard]]
+        VulkanFramebufferCache *get_framebuffer_cache() const {
+            return framebuffer_cache.get();
+        }
+
+        [[nodiscard]]
+        bool has_imageless_framebuffer() const {
+            return imageless_framebuffer;
+        }
+
+        [[nodiscard]]
+        bool has_dynamic_rendering() const {
+            return dynamic_rendering;
+        }
+
+        [[nodiscard]]
+        PFN_vkCmdBeginRenderingKHR get_vk_cmd_begin_rendering() const {
+            return vk_cmd_begin_rendering;
+        }
+
+        [[nodiscard]]
+        PFN_vkCmdEndRenderingKHR get_vk_cmd_end_rendering() const {
+            return vk_cmd_end_rendering;
+        }
     };
 }
 
@@ -0,0 +1,68 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_pipeline.hpp"
+
+#include <mana/internal/vulkan_cmd_buffer.hpp>
+
+#include <stdexcept>
+
+using namespace ManaVK::Internal;
+
+VulkanPipeline::VulkanPipeline(const PipelineConfig &config) {
+    this->vk_pipeline = config.vk_pipeline;
+    this->vk_pipeline_layout = config.vk_pipeline_layout;
+    this->vk_bind_point = config.vk_bind_point;
+    this->vk_set_layouts = config.vk_set_layouts;
+}
+
+void VulkanPipeline::bind(VulkanCmdBuffer *vulkan_cmd_buffer) const {
+    if (vulkan_cmd_buffer == nullptr) {
+        throw std::runtime_error("vulkan_cmd_buffer was nullptr!");
+    }
+
+    vkCmdBindPipeline(vulkan_cmd_buffer->get_vk_cmd_buffer(), vk_bind_point, vk_pipeline);
+}
+
+void VulkanPipeline::release(VkDevice vk_device) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    if (vk_pipeline != nullptr) {
+        vkDestroyPipeline(vk_device, vk_pipeline, nullptr);
+        vk_pipeline = nullptr;
+    }
+
+    if (vk_pipeline_layout != nullptr) {
+        vkDestroyPipelineLayout(vk_device, vk_pipeline_layout, nullptr);
+        vk_pipeline_layout = nullptr;
+    }
+
+    for (auto vk_set_layout : vk_set_layouts) {
+        vkDestroyDescriptorSetLayout(vk_device, vk_set_layout, nullptr);
+    }
+
+    vk_set_layouts.clear();
+}
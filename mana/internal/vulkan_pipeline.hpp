@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_PIPELINE_HPP
+#define MANA_VULKAN_PIPELINE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanCmdBuffer;
+
+    // A graphics or compute VkPipeline along with the layout it was built with, see VulkanPipelineBuilder
+    class VulkanPipeline {
+    public:
+        struct PipelineConfig {
+            VkPipeline vk_pipeline = nullptr;
+            VkPipelineLayout vk_pipeline_layout = nullptr;
+            VkPipelineBindPoint vk_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+            // Owned by the pipeline, in set order
+            std::vector<VkDescriptorSetLayout> vk_set_layouts;
+        };
+
+    protected:
+        VkPipeline vk_pipeline = nullptr;
+        VkPipelineLayout vk_pipeline_layout = nullptr;
+        VkPipelineBindPoint vk_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        std::vector<VkDescriptorSetLayout> vk_set_layouts;
+
+    public:
+        VulkanPipeline(const PipelineConfig &config);
+
+        void bind(VulkanCmdBuffer *vulkan_cmd_buffer) const;
+
+        void release(VkDevice vk_device);
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        VkPipeline get_vk_pipeline() const {
+            return vk_pipeline;
+        }
+
+        [[nodiscard]]
+        VkPipelineLayout get_vk_pipeline_layout() const {
+            return vk_pipeline_layout;
+        }
+
+        [[nodiscard]]
+        VkPipelineBindPoint get_vk_bind_point() const {
+            return vk_bind_point;
+        }
+
+        [[nodiscard]]
+        VkDescriptorSetLayout get_vk_set_layout(uint32_t set) const {
+            return vk_set_layouts[set];
+        }
+    };
+}
+
+#endif//MANA_VULKAN_PIPELINE_HPP
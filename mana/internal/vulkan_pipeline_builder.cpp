@@ -0,0 +1,876 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_pipeline_builder.hpp"
+
+#include <mana/internal/vulkan_pipeline.hpp>
+#include <mana/internal/vulkan_pipeline_cache.hpp>
+#include <mana/internal/vulkan_pipeline_recorder.hpp>
+#include <mana/internal/vulkan_render_pass.hpp>
+#include <mana/internal/vulkan_render_pass_builder.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+using namespace ManaVK;
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanPipelineBuilder]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+// The color attachments a pipeline on the subpass writes, in the order it writes them
+// Dynamic passes bind every color attachment in order when they begin, whatever order the outputs were pushed in
+static Internal::FixedVector<uint32_t, Internal::VulkanRenderPass::MAX_ATTACHMENTS> get_color_indices(const Internal::VulkanRenderPass *vulkan_render_pass, uint32_t subpass) {
+    const auto &subpass_desc = vulkan_render_pass->get_subpass(subpass);
+
+    if (!vulkan_render_pass->is_dynamic()) {
+        return subpass_desc.color_indices;
+    }
+
+    Internal::FixedVector<uint32_t, Internal::VulkanRenderPass::MAX_ATTACHMENTS> color_indices;
+
+    for (uint32_t a = 0; a < vulkan_render_pass->get_attachment_count(); a++) {
+        if (a != subpass_desc.depth_index) {
+            color_indices.push_back(a);
+        }
+    }
+
+    return color_indices;
+}
+
+// Strings are stored as their length followed by the bytes, four to a word
+static void write_string(std::vector<uint32_t> &words, const std::string &string) {
+    words.push_back(static_cast<uint32_t>(string.size()));
+
+    for (size_t c = 0; c < string.size(); c += 4) {
+        uint32_t word = 0;
+
+        for (size_t b = 0; b < 4 && c + b < string.size(); b++) {
+            word |= static_cast<uint32_t>(static_cast<uint8_t>(string[c + b])) << (b * 8);
+        }
+
+        words.push_back(word);
+    }
+}
+
+// Bounds checked, reading past the end just returns zeroes and clears ok
+struct WordReader {
+    const std::vector<uint32_t> &words;
+    size_t cursor = 0;
+    bool ok = true;
+
+    uint32_t next() {
+        if (cursor >= words.size()) {
+            ok = false;
+            return 0;
+        }
+
+        return words[cursor++];
+    }
+
+    // Counts are checked against what's left, so corrupt data can't ask for huge allocations
+    uint32_t next_count() {
+        uint32_t count = next();
+
+        if (count > words.size() - std::min(cursor, words.size())) {
+            ok = false;
+            return 0;
+        }
+
+        return count;
+    }
+
+    std::string next_string() {
+        uint32_t length = next();
+
+        if (length > (words.size() - std::min(cursor, words.size())) * 4) {
+            ok = false;
+            return {};
+        }
+
+        std::string string(length, '\0');
+
+        for (size_t c = 0; c < length; c += 4) {
+            uint32_t word = next();
+
+            for (size_t b = 0; b < 4 && c + b < length; b++) {
+                string[c + b] = static_cast<char>((word >> (b * 8)) & 0xFF);
+            }
+        }
+
+        return string;
+    }
+};
+
+void Internal::VulkanPipelineBuilder::push_shader(const ShaderInfo &info) {
+    shaders.emplace_back(info);
+}
+
+void Internal::VulkanPipelineBuilder::push_vertex_binding(const VertexBinding &binding) {
+    vertex_bindings.emplace_back(binding);
+}
+
+void Internal::VulkanPipelineBuilder::push_vertex_attribute(const VertexAttribute &attribute) {
+    vertex_attributes.emplace_back(attribute);
+}
+
+void Internal::VulkanPipelineBuilder::set_raster(const RasterInfo &info) {
+    raster = info;
+}
+
+void Internal::VulkanPipelineBuilder::set_depth(const DepthInfo &info) {
+    depth = info;
+}
+
+void Internal::VulkanPipelineBuilder::push_blend(const BlendInfo &info) {
+    blends.emplace_back(info);
+}
+
+void Internal::VulkanPipelineBuilder::push_set_layout(const SetLayoutInfo &info) {
+    set_layouts.emplace_back(info);
+}
+
+void Internal::VulkanPipelineBuilder::push_constant_range(const VkPushConstantRange &vk_range) {
+    vk_push_constants.emplace_back(vk_range);
+}
+
+void Internal::VulkanPipelineBuilder::set_render_pass(VulkanRenderPass *vulkan_render_pass, uint32_t subpass) {
+    this->vulkan_render_pass = vulkan_render_pass;
+    this->subpass = subpass;
+}
+
+std::shared_ptr<Internal::VulkanPipeline> Internal::VulkanPipelineBuilder::build_graphics(VkDevice vk_device, VulkanPipelineCache *cache, VulkanPipelineRecorder *recorder) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    if (vulkan_render_pass == nullptr) {
+        throw std::runtime_error("vulkan_render_pass was nullptr! Graphics pipelines need a render pass!");
+    }
+
+    if (shaders.empty()) {
+        throw std::runtime_error("shaders was empty, this is not allowed!");
+    }
+
+    if (subpass >= vulkan_render_pass->get_subpass_count()) {
+        throw std::runtime_error("subpass is out of range for the render pass!");
+    }
+
+    //
+    // Attachment info
+    //
+    // Only what the target subpass writes counts, other subpasses may draw to different attachments
+    // Every attachment a subpass uses shares one sample count, so any of them will do
+    FixedVector<VkFormat, VulkanRenderPass::MAX_ATTACHMENTS> vk_color_formats;
+    VkFormat vk_depth_format = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits vk_samples = VK_SAMPLE_COUNT_1_BIT;
+    {
+        const auto &subpass_desc = vulkan_render_pass->get_subpass(subpass);
+
+        for (auto index : get_color_indices(vulkan_render_pass, subpass)) {
+            const auto &attachment = vulkan_render_pass->get_attachment(index);
+
+            vk_color_formats.push_back(attachment.vk_format);
+            vk_samples = attachment.vk_samples;
+        }
+
+        if (subpass_desc.depth_index.has_value()) {
+            const auto &attachment = vulkan_render_pass->get_attachment(subpass_desc.depth_index.value());
+
+            vk_depth_format = attachment.vk_format;
+            vk_samples = attachment.vk_samples;
+        }
+    }
+
+    //
+    // Stage creation
+    //
+    std::vector<VkShaderModule> vk_modules;
+    std::vector<VkPipelineShaderStageCreateInfo> vk_stages;
+
+    auto release_modules = [&vk_modules, vk_device]() {
+        for (auto vk_module : vk_modules) {
+            vkDestroyShaderModule(vk_device, vk_module, nullptr);
+        }
+    };
+
+    for (const auto &shader : shaders) {
+        VkShaderModule vk_module = nullptr;
+
+        try {
+            vk_module = create_module(vk_device, shader);
+        } catch (...) {
+            release_modules();
+            throw;
+        }
+
+        vk_modules.push_back(vk_module);
+
+        VkPipelineShaderStageCreateInfo vk_stage {};
+        {
+            vk_stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+
+            vk_stage.stage = shader.vk_stage;
+            vk_stage.module = vk_module;
+            vk_stage.pName = shader.entry_point.c_str();
+        }
+
+        vk_stages.push_back(vk_stage);
+    }
+
+    //
+    // Fixed function state
+    //
+    std::vector<VkVertexInputBindingDescription> vk_bindings;
+    {
+        for (const auto &binding : vertex_bindings) {
+            VkVertexInputBindingDescription vk_binding {};
+            {
+                vk_binding.binding = binding.binding;
+                vk_binding.stride = binding.stride;
+                vk_binding.inputRate = binding.vk_input_rate;
+            }
+
+            vk_bindings.push_back(vk_binding);
+        }
+    }
+
+    std::vector<VkVertexInputAttributeDescription> vk_attributes;
+    {
+        for (const auto &attribute : vertex_attributes) {
+            VkVertexInputAttributeDescription vk_attribute {};
+            {
+                vk_attribute.location = attribute.location;
+                vk_attribute.binding = attribute.binding;
+                vk_attribute.format = attribute.vk_format;
+                vk_attribute.offset = attribute.offset;
+            }
+
+            vk_attributes.push_back(vk_attribute);
+        }
+    }
+
+    VkPipelineVertexInputStateCreateInfo vertex_input_info {};
+    {
+        vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        vertex_input_info.vertexBindingDescriptionCount = static_cast<uint32_t>(vk_bindings.size());
+        vertex_input_info.pVertexBindingDescriptions = vk_bindings.data();
+
+        vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(vk_attributes.size());
+        vertex_input_info.pVertexAttributeDescriptions = vk_attributes.data();
+    }
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_info {};
+    {
+        input_assembly_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        input_assembly_info.topology = raster.vk_topology;
+    }
+
+    VkPipelineViewportStateCreateInfo viewport_info {};
+    {
+        viewport_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport_info.viewportCount = 1;
+        viewport_info.scissorCount = 1;
+    }
+
+    VkPipelineRasterizationStateCreateInfo rasterization_info {};
+    {
+        rasterization_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+
+        rasterization_info.polygonMode = raster.vk_polygon_mode;
+        rasterization_info.cullMode = raster.vk_cull_mode;
+        rasterization_info.frontFace = raster.vk_front_face;
+        rasterization_info.lineWidth = 1.0F;
+    }
+
+    VkPipelineMultisampleStateCreateInfo multisample_info {};
+    {
+        multisample_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample_info.rasterizationSamples = vk_samples;
+    }
+
+    VkPipelineDepthStencilStateCreateInfo depth_stencil_info {};
+    {
+        depth_stencil_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        depth_stencil_info.depthTestEnable = depth.test;
+        depth_stencil_info.depthWriteEnable = depth.write;
+        depth_stencil_info.depthCompareOp = depth.vk_compare_op;
+    }
+
+    std::vector<VkPipelineColorBlendAttachmentState> vk_blend_states;
+    {
+        for (uint32_t c = 0; c < vk_color_formats.size(); c++) {
+            BlendInfo blend = c < blends.size() ? blends[c] : BlendInfo();
+
+            VkPipelineColorBlendAttachmentState vk_blend_state {};
+            {
+                vk_blend_state.blendEnable = blend.enable;
+
+                vk_blend_state.srcColorBlendFactor = blend.vk_src_color;
+                vk_blend_state.dstColorBlendFactor = blend.vk_dst_color;
+                vk_blend_state.colorBlendOp = blend.vk_color_op;
+
+                vk_blend_state.srcAlphaBlendFactor = blend.vk_src_alpha;
+                vk_blend_state.dstAlphaBlendFactor = blend.vk_dst_alpha;
+                vk_blend_state.alphaBlendOp = blend.vk_alpha_op;
+
+                vk_blend_state.colorWriteMask = blend.vk_write_mask;
+            }
+
+            vk_blend_states.push_back(vk_blend_state);
+        }
+    }
+
+    VkPipelineColorBlendStateCreateInfo color_blend_info {};
+    {
+        color_blend_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+
+        color_blend_info.attachmentCount = static_cast<uint32_t>(vk_blend_states.size());
+        color_blend_info.pAttachments = vk_blend_states.data();
+    }
+
+    VkDynamicState vk_dynamic_states[] = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamic_state_info {};
+    {
+        dynamic_state_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+
+        dynamic_state_info.dynamicStateCount = 2;
+        dynamic_state_info.pDynamicStates = vk_dynamic_states;
+    }
+
+    VkPipelineRenderingCreateInfoKHR rendering_info {};
+    {
+        rendering_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+
+        rendering_info.colorAttachmentCount = static_cast<uint32_t>(vk_color_formats.size());
+        rendering_info.pColorAttachmentFormats = vk_color_formats.data();
+        rendering_info.depthAttachmentFormat = vk_depth_format;
+
+        if (VulkanRenderPass::has_stencil(vk_depth_format)) {
+            rendering_info.stencilAttachmentFormat = vk_depth_format;
+        }
+    }
+
+    //
+    // Pipeline creation
+    //
+    std::vector<VkDescriptorSetLayout> vk_set_layouts;
+    VkPipelineLayout vk_pipeline_layout = nullptr;
+
+    try {
+        vk_pipeline_layout = create_layout(vk_device, vk_set_layouts);
+    } catch (...) {
+        release_modules();
+        throw;
+    }
+
+    VkGraphicsPipelineCreateInfo pipeline_info {};
+    {
+        pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+
+        pipeline_info.stageCount = static_cast<uint32_t>(vk_stages.size());
+        pipeline_info.pStages = vk_stages.data();
+
+        pipeline_info.pVertexInputState = &vertex_input_info;
+        pipeline_info.pInputAssemblyState = &input_assembly_info;
+        pipeline_info.pViewportState = &viewport_info;
+        pipeline_info.pRasterizationState = &rasterization_info;
+        pipeline_info.pMultisampleState = &multisample_info;
+        pipeline_info.pColorBlendState = &color_blend_info;
+        pipeline_info.pDynamicState = &dynamic_state_info;
+
+        if (vulkan_render_pass->has_depth()) {
+            pipeline_info.pDepthStencilState = &depth_stencil_info;
+        }
+
+        pipeline_info.layout = vk_pipeline_layout;
+
+        if (vulkan_render_pass->is_dynamic()) {
+            pipeline_info.pNext = &rendering_info;
+        } else {
+            pipeline_info.renderPass = vulkan_render_pass->get_vk_render_pass();
+            pipeline_info.subpass = subpass;
+        }
+    }
+
+    VkPipelineCache vk_pipeline_cache = cache != nullptr ? cache->get_vk_pipeline_cache() : nullptr;
+
+    VkPipeline vk_pipeline = nullptr;
+    VkResult result = vkCreateGraphicsPipelines(vk_device, vk_pipeline_cache, 1, &pipeline_info, nullptr, &vk_pipeline);
+
+    release_modules();
+
+    if (result != VK_SUCCESS) {
+        release_layout(vk_device, vk_pipeline_layout, vk_set_layouts);
+
+        LOG("vkCreateGraphicsPipelines failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreateGraphicsPipelines failed! Please check the log above for more info!");
+    }
+
+    VulkanPipeline::PipelineConfig config {};
+    {
+        config.vk_pipeline = vk_pipeline;
+        config.vk_pipeline_layout = vk_pipeline_layout;
+        config.vk_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        config.vk_set_layouts = vk_set_layouts;
+    }
+
+    if (recorder != nullptr) {
+        recorder->record(*this, false);
+    }
+
+    return std::make_shared<VulkanPipeline>(config);
+}
+
+std::shared_ptr<Internal::VulkanPipeline> Internal::VulkanPipelineBuilder::build_compute(VkDevice vk_device, VulkanPipelineCache *cache, VulkanPipelineRecorder *recorder) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    if (shaders.size() != 1 || shaders[0].vk_stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+        throw std::runtime_error("Compute pipelines need exactly one compute shader!");
+    }
+
+    VkShaderModule vk_module = create_module(vk_device, shaders[0]);
+
+    std::vector<VkDescriptorSetLayout> vk_set_layouts;
+    VkPipelineLayout vk_pipeline_layout = nullptr;
+
+    try {
+        vk_pipeline_layout = create_layout(vk_device, vk_set_layouts);
+    } catch (...) {
+        vkDestroyShaderModule(vk_device, vk_module, nullptr);
+        throw;
+    }
+
+    VkComputePipelineCreateInfo pipeline_info {};
+    {
+        pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+
+        pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipeline_info.stage.module = vk_module;
+        pipeline_info.stage.pName = shaders[0].entry_point.c_str();
+
+        pipeline_info.layout = vk_pipeline_layout;
+    }
+
+    VkPipelineCache vk_pipeline_cache = cache != nullptr ? cache->get_vk_pipeline_cache() : nullptr;
+
+    VkPipeline vk_pipeline = nullptr;
+    VkResult result = vkCreateComputePipelines(vk_device, vk_pipeline_cache, 1, &pipeline_info, nullptr, &vk_pipeline);
+
+    vkDestroyShaderModule(vk_device, vk_module, nullptr);
+
+    if (result != VK_SUCCESS) {
+        release_layout(vk_device, vk_pipeline_layout, vk_set_layouts);
+
+        LOG("vkCreateComputePipelines failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreateComputePipelines failed! Please check the log above for more info!");
+    }
+
+    VulkanPipeline::PipelineConfig config {};
+    {
+        config.vk_pipeline = vk_pipeline;
+        config.vk_pipeline_layout = vk_pipeline_layout;
+        config.vk_bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+        config.vk_set_layouts = vk_set_layouts;
+    }
+
+    if (recorder != nullptr) {
+        recorder->record(*this, true);
+    }
+
+    return std::make_shared<VulkanPipeline>(config);
+}
+
+//
+// Descriptions
+//
+void Internal::VulkanPipelineBuilder::write_description(std::vector<uint32_t> &words, const std::function<uint32_t(const std::vector<uint32_t> &)> &shader_index) const {
+    words.push_back(static_cast<uint32_t>(shaders.size()));
+    for (const auto &shader : shaders) {
+        words.push_back(shader.vk_stage);
+        words.push_back(shader_index(shader.spirv));
+        write_string(words, shader.entry_point);
+    }
+
+    words.push_back(static_cast<uint32_t>(vertex_bindings.size()));
+    for (const auto &binding : vertex_bindings) {
+        words.push_back(binding.binding);
+        words.push_back(binding.stride);
+        words.push_back(binding.vk_input_rate);
+    }
+
+    words.push_back(static_cast<uint32_t>(vertex_attributes.size()));
+    for (const auto &attribute : vertex_attributes) {
+        words.push_back(attribute.location);
+        words.push_back(attribute.binding);
+        words.push_back(attribute.vk_format);
+        words.push_back(attribute.offset);
+    }
+
+    words.push_back(raster.vk_topology);
+    words.push_back(raster.vk_polygon_mode);
+    words.push_back(raster.vk_cull_mode);
+    words.push_back(raster.vk_front_face);
+
+    words.push_back(depth.test);
+    words.push_back(depth.write);
+    words.push_back(depth.vk_compare_op);
+
+    words.push_back(static_cast<uint32_t>(blends.size()));
+    for (const auto &blend : blends) {
+        words.push_back(blend.enable);
+        words.push_back(blend.vk_src_color);
+        words.push_back(blend.vk_dst_color);
+        words.push_back(blend.vk_color_op);
+        words.push_back(blend.vk_src_alpha);
+        words.push_back(blend.vk_dst_alpha);
+        words.push_back(blend.vk_alpha_op);
+        words.push_back(blend.vk_write_mask);
+    }
+
+    words.push_back(static_cast<uint32_t>(set_layouts.size()));
+    for (const auto &set_layout : set_layouts) {
+        words.push_back(static_cast<uint32_t>(set_layout.bindings.size()));
+
+        for (const auto &binding : set_layout.bindings) {
+            words.push_back(binding.binding);
+            words.push_back(binding.vk_type);
+            words.push_back(binding.count);
+            words.push_back(binding.vk_stages);
+        }
+    }
+
+    words.push_back(static_cast<uint32_t>(vk_push_constants.size()));
+    for (const auto &vk_range : vk_push_constants) {
+        words.push_back(vk_range.stageFlags);
+        words.push_back(vk_range.offset);
+        words.push_back(vk_range.size);
+    }
+
+    // Only the subpass's own attachments are written, replays rebuild a single subpass pass out of them
+    words.push_back(vulkan_render_pass != nullptr);
+    if (vulkan_render_pass != nullptr) {
+        auto indices = get_color_indices(vulkan_render_pass, subpass);
+        auto depth_index = vulkan_render_pass->get_subpass(subpass).depth_index;
+
+        if (depth_index.has_value()) {
+            indices.push_back(depth_index.value());
+        }
+
+        words.push_back(vulkan_render_pass->is_dynamic());
+        words.push_back(depth_index.has_value());
+
+        words.push_back(static_cast<uint32_t>(indices.size()));
+        for (auto a : indices) {
+            const auto &attachment = vulkan_render_pass->get_attachment(a);
+
+            words.push_back(attachment.vk_format);
+            words.push_back(attachment.vk_samples);
+            words.push_back(attachment.vk_load_op);
+            words.push_back(attachment.vk_store_op);
+            words.push_back(attachment.vk_stencil_load_op);
+            words.push_back(attachment.vk_stencil_store_op);
+            words.push_back(attachment.vk_layout_initial);
+            words.push_back(attachment.vk_layout_ref);
+            words.push_back(attachment.vk_layout_final);
+        }
+
+        words.push_back(subpass);
+    }
+}
+
+bool Internal::VulkanPipelineBuilder::read_description(
+    VkDevice vk_device,
+    VulkanRenderPassCache *render_pass_cache,
+    const std::vector<uint32_t> &words,
+    const std::vector<std::vector<uint32_t>> &shader_table
+) {
+    if (render_pass_cache == nullptr) {
+        throw std::runtime_error("render_pass_cache was nullptr!");
+    }
+
+    WordReader reader {words};
+
+    uint32_t shader_count = reader.next_count();
+    for (uint32_t s = 0; s < shader_count; s++) {
+        ShaderInfo shader;
+        {
+            shader.vk_stage = static_cast<VkShaderStageFlagBits>(reader.next());
+
+            uint32_t index = reader.next();
+            if (index >= shader_table.size()) {
+                return false;
+            }
+
+            shader.spirv = shader_table[index];
+            shader.entry_point = reader.next_string();
+        }
+
+        push_shader(shader);
+    }
+
+    uint32_t binding_count = reader.next_count();
+    for (uint32_t b = 0; b < binding_count; b++) {
+        VertexBinding binding;
+        {
+            binding.binding = reader.next();
+            binding.stride = reader.next();
+            binding.vk_input_rate = static_cast<VkVertexInputRate>(reader.next());
+        }
+
+        push_vertex_binding(binding);
+    }
+
+    uint32_t attribute_count = reader.next_count();
+    for (uint32_t a = 0; a < attribute_count; a++) {
+        VertexAttribute attribute;
+        {
+            attribute.location = reader.next();
+            attribute.binding = reader.next();
+            attribute.vk_format = static_cast<VkFormat>(reader.next());
+            attribute.offset = reader.next();
+        }
+
+        push_vertex_attribute(attribute);
+    }
+
+    raster.vk_topology = static_cast<VkPrimitiveTopology>(reader.next());
+    raster.vk_polygon_mode = static_cast<VkPolygonMode>(reader.next());
+    raster.vk_cull_mode = reader.next();
+    raster.vk_front_face = static_cast<VkFrontFace>(reader.next());
+
+    depth.test = reader.next();
+    depth.write = reader.next();
+    depth.vk_compare_op = static_cast<VkCompareOp>(reader.next());
+
+    uint32_t blend_count = reader.next_count();
+    for (uint32_t b = 0; b < blend_count; b++) {
+        BlendInfo blend;
+        {
+            blend.enable = reader.next();
+            blend.vk_src_color = static_cast<VkBlendFactor>(reader.next());
+            blend.vk_dst_color = static_cast<VkBlendFactor>(reader.next());
+            blend.vk_color_op = static_cast<VkBlendOp>(reader.next());
+            blend.vk_src_alpha = static_cast<VkBlendFactor>(reader.next());
+            blend.vk_dst_alpha = static_cast<VkBlendFactor>(reader.next());
+            blend.vk_alpha_op = static_cast<VkBlendOp>(reader.next());
+            blend.vk_write_mask = reader.next();
+        }
+
+        push_blend(blend);
+    }
+
+    uint32_t set_count = reader.next_count();
+    for (uint32_t s = 0; s < set_count; s++) {
+        SetLayoutInfo set_layout;
+
+        uint32_t set_binding_count = reader.next_count();
+        for (uint32_t b = 0; b < set_binding_count; b++) {
+            SetBinding binding;
+            {
+                binding.binding = reader.next();
+                binding.vk_type = static_cast<VkDescriptorType>(reader.next());
+                binding.count = reader.next();
+                binding.vk_stages = reader.next();
+            }
+
+            set_layout.bindings.push_back(binding);
+        }
+
+        push_set_layout(set_layout);
+    }
+
+    uint32_t push_constant_count = reader.next_count();
+    for (uint32_t p = 0; p < push_constant_count; p++) {
+        VkPushConstantRange vk_range {};
+        {
+            vk_range.stageFlags = reader.next();
+            vk_range.offset = reader.next();
+            vk_range.size = reader.next();
+        }
+
+        push_constant_range(vk_range);
+    }
+
+    if (reader.next()) {
+        bool dynamic = reader.next();
+        bool has_depth = reader.next();
+
+        uint32_t attachment_count = reader.next_count();
+
+        if (attachment_count > VulkanRenderPass::MAX_ATTACHMENTS || (has_depth && attachment_count == 0)) {
+            return false;
+        }
+
+        VulkanRenderPassBuilder pass_builder;
+        VulkanRenderPassBuilder::SubpassInfo subpass_info;
+
+        for (uint32_t a = 0; a < attachment_count; a++) {
+            VulkanRenderPassBuilder::AttachmentInfo info;
+            {
+                info.vk_format = static_cast<VkFormat>(reader.next());
+                info.vk_samples = static_cast<VkSampleCountFlagBits>(reader.next());
+                info.vk_load_op = static_cast<VkAttachmentLoadOp>(reader.next());
+                info.vk_store_op = static_cast<VkAttachmentStoreOp>(reader.next());
+                info.vk_stencil_load_op = static_cast<VkAttachmentLoadOp>(reader.next());
+                info.vk_stencil_store_op = static_cast<VkAttachmentStoreOp>(reader.next());
+                info.vk_layout_initial = static_cast<VkImageLayout>(reader.next());
+                info.vk_layout_ref = static_cast<VkImageLayout>(reader.next());
+                info.vk_layout_final = static_cast<VkImageLayout>(reader.next());
+            }
+
+            if (has_depth && a == attachment_count - 1) {
+                pass_builder.set_depth_attachment(info);
+                subpass_info.depth_index = a;
+            } else {
+                pass_builder.push_color_attachment(info);
+                subpass_info.output_indices.push_back(a);
+            }
+        }
+
+        // Only single subpass passes can be rebuilt, the recorder leaves the others out
+        if (reader.next() != 0 || !reader.ok) {
+            return false;
+        }
+
+        // Dependencies don't affect compatibility, so the rebuilt pass works for the recorded pipeline
+        pass_builder.push_subpass(subpass_info);
+        pass_builder.set_dynamic(dynamic);
+
+        set_render_pass(pass_builder.build(vk_device, render_pass_cache).get());
+    }
+
+    return reader.ok && reader.cursor == words.size();
+}
+
+//
+// Helpers
+//
+VkPipelineLayout Internal::VulkanPipelineBuilder::create_layout(VkDevice vk_device, std::vector<VkDescriptorSetLayout> &vk_set_layouts) const {
+    for (const auto &set_layout : set_layouts) {
+        std::vector<VkDescriptorSetLayoutBinding> vk_bindings;
+
+        for (const auto &binding : set_layout.bindings) {
+            VkDescriptorSetLayoutBinding vk_binding {};
+            {
+                vk_binding.binding = binding.binding;
+                vk_binding.descriptorType = binding.vk_type;
+                vk_binding.descriptorCount = binding.count;
+                vk_binding.stageFlags = binding.vk_stages;
+            }
+
+            vk_bindings.push_back(vk_binding);
+        }
+
+        VkDescriptorSetLayoutCreateInfo set_layout_info {};
+        {
+            set_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+
+            set_layout_info.bindingCount = static_cast<uint32_t>(vk_bindings.size());
+            set_layout_info.pBindings = vk_bindings.data();
+        }
+
+        VkDescriptorSetLayout vk_set_layout = nullptr;
+        VkResult result = vkCreateDescriptorSetLayout(vk_device, &set_layout_info, nullptr, &vk_set_layout);
+
+        if (result != VK_SUCCESS) {
+            release_layout(vk_device, nullptr, vk_set_layouts);
+            vk_set_layouts.clear();
+
+            LOG("vkCreateDescriptorSetLayout failed with error code (" << string_VkResult(result) << ")");
+            throw std::runtime_error("vkCreateDescriptorSetLayout failed! Please check the log above for more info!");
+        }
+
+        vk_set_layouts.push_back(vk_set_layout);
+    }
+
+    VkPipelineLayoutCreateInfo layout_info {};
+    {
+        layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+
+        layout_info.setLayoutCount = static_cast<uint32_t>(vk_set_layouts.size());
+        layout_info.pSetLayouts = vk_set_layouts.data();
+
+        layout_info.pushConstantRangeCount = static_cast<uint32_t>(vk_push_constants.size());
+        layout_info.pPushConstantRanges = vk_push_constants.data();
+    }
+
+    VkPipelineLayout vk_pipeline_layout = nullptr;
+    VkResult result = vkCreatePipelineLayout(vk_device, &layout_info, nullptr, &vk_pipeline_layout);
+
+    if (result != VK_SUCCESS) {
+        release_layout(vk_device, nullptr, vk_set_layouts);
+        vk_set_layouts.clear();
+
+        LOG("vkCreatePipelineLayout failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreatePipelineLayout failed! Please check the log above for more info!");
+    }
+
+    return vk_pipeline_layout;
+}
+
+void Internal::VulkanPipelineBuilder::release_layout(VkDevice vk_device, VkPipelineLayout vk_pipeline_layout, const std::vector<VkDescriptorSetLayout> &vk_set_layouts) {
+    if (vk_pipeline_layout != nullptr) {
+        vkDestroyPipelineLayout(vk_device, vk_pipeline_layout, nullptr);
+    }
+
+    for (auto vk_set_layout : vk_set_layouts) {
+        vkDestroyDescriptorSetLayout(vk_device, vk_set_layout, nullptr);
+    }
+}
+
+VkShaderModule Internal::VulkanPipelineBuilder::create_module(VkDevice vk_device, const ShaderInfo &info) {
+    if (info.spirv.empty()) {
+        throw std::runtime_error("Shader SPIR-V was empty!");
+    }
+
+    VkShaderModuleCreateInfo module_info {};
+    {
+        module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+
+        module_info.codeSize = info.spirv.size() * sizeof(uint32_t);
+        module_info.pCode = info.spirv.data();
+    }
+
+    VkShaderModule vk_module = nullptr;
+    VkResult result = vkCreateShaderModule(vk_device, &module_info, nullptr, &vk_module);
+
+    if (result != VK_SUCCESS) {
+        LOG("vkCreateShaderModule failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreateShaderModule failed! Please check the log above for more info!");
+    }
+
+    return vk_module;
+}
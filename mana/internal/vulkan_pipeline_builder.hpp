@@ -0,0 +1,186 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_PIPELINE_BUILDER_HPP
+#define MANA_VULKAN_PIPELINE_BUILDER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanPipeline;
+    class VulkanPipelineCache;
+    class VulkanPipelineRecorder;
+    class VulkanRenderPass;
+    class VulkanRenderPassCache;
+
+    // Viewport and scissor are always dynamic, so pipelines survive swapchain resizes
+    // Dynamic render passes are built against their attachment formats instead of a VkRenderPass
+    class VulkanPipelineBuilder {
+    public:
+        struct ShaderInfo {
+            VkShaderStageFlagBits vk_stage = VK_SHADER_STAGE_VERTEX_BIT;
+
+            // SPIR-V words, the module only lives until the pipeline is built
+            std::vector<uint32_t> spirv;
+            std::string entry_point = "main";
+        };
+
+        struct VertexBinding {
+            uint32_t binding = 0;
+            uint32_t stride = 0;
+            VkVertexInputRate vk_input_rate = VK_VERTEX_INPUT_RATE_VERTEX;
+        };
+
+        struct VertexAttribute {
+            uint32_t location = 0;
+            uint32_t binding = 0;
+            VkFormat vk_format = VK_FORMAT_UNDEFINED;
+            uint32_t offset = 0;
+        };
+
+        struct RasterInfo {
+            VkPrimitiveTopology vk_topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            VkPolygonMode vk_polygon_mode = VK_POLYGON_MODE_FILL;
+            VkCullModeFlags vk_cull_mode = VK_CULL_MODE_BACK_BIT;
+            VkFrontFace vk_front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        };
+
+        // Ignored when the render pass has no depth attachment
+        struct DepthInfo {
+            bool test = true;
+            bool write = true;
+            VkCompareOp vk_compare_op = VK_COMPARE_OP_LESS_OR_EQUAL;
+        };
+
+        struct BlendInfo {
+            bool enable = false;
+
+            VkBlendFactor vk_src_color = VK_BLEND_FACTOR_SRC_ALPHA;
+            VkBlendFactor vk_dst_color = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            VkBlendOp vk_color_op = VK_BLEND_OP_ADD;
+
+            VkBlendFactor vk_src_alpha = VK_BLEND_FACTOR_ONE;
+            VkBlendFactor vk_dst_alpha = VK_BLEND_FACTOR_ZERO;
+            VkBlendOp vk_alpha_op = VK_BLEND_OP_ADD;
+
+            VkColorComponentFlags vk_write_mask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        };
+
+        // Immutable samplers aren't supported, every layout is described by value so pipelines can be recorded
+        struct SetBinding {
+            uint32_t binding = 0;
+            VkDescriptorType vk_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            uint32_t count = 1;
+            VkShaderStageFlags vk_stages = VK_SHADER_STAGE_ALL;
+        };
+
+        struct SetLayoutInfo {
+            std::vector<SetBinding> bindings;
+        };
+
+    protected:
+        std::vector<ShaderInfo> shaders;
+
+        std::vector<VertexBinding> vertex_bindings;
+        std::vector<VertexAttribute> vertex_attributes;
+
+        RasterInfo raster;
+        DepthInfo depth;
+
+        // One per color attachment, attachments without one don't blend
+        std::vector<BlendInfo> blends;
+
+        std::vector<SetLayoutInfo> set_layouts;
+        std::vector<VkPushConstantRange> vk_push_constants;
+
+        VulkanRenderPass *vulkan_render_pass = nullptr;
+        uint32_t subpass = 0;
+
+    public:
+        //
+        // Methods
+        //
+        void push_shader(const ShaderInfo &info);
+
+        void push_vertex_binding(const VertexBinding &binding);
+        void push_vertex_attribute(const VertexAttribute &attribute);
+
+        void set_raster(const RasterInfo &info);
+        void set_depth(const DepthInfo &info);
+        void push_blend(const BlendInfo &info);
+
+        // The set layouts are created with the pipeline and owned by it, see VulkanPipeline::get_vk_set_layout()
+        void push_set_layout(const SetLayoutInfo &info);
+        void push_constant_range(const VkPushConstantRange &vk_range);
+
+        // Graphics only, the pass only needs to outlive the build() call
+        void set_render_pass(VulkanRenderPass *vulkan_render_pass, uint32_t subpass = 0);
+
+        // Without a cache every build is compiled from scratch
+        // With a recorder, the description is added to its manifest once the pipeline is built
+        std::shared_ptr<VulkanPipeline> build_graphics(VkDevice vk_device, VulkanPipelineCache *cache = nullptr, VulkanPipelineRecorder *recorder = nullptr);
+        std::shared_ptr<VulkanPipeline> build_compute(VkDevice vk_device, VulkanPipelineCache *cache = nullptr, VulkanPipelineRecorder *recorder = nullptr);
+
+        //
+        // Descriptions
+        //
+
+        // Flattens everything into words, shaders are written as whatever index shader_index hands out for their SPIR-V
+        // The render pass is written as its attachments, enough to rebuild a compatible pass
+        void write_description(std::vector<uint32_t> &words, const std::function<uint32_t(const std::vector<uint32_t> &)> &shader_index) const;
+
+        // The inverse of write_description(), the render pass is rebuilt through the cache which then keeps it alive
+        // Returns false if the words are malformed
+        bool read_description(
+            VkDevice vk_device,
+            VulkanRenderPassCache *render_pass_cache,
+            const std::vector<uint32_t> &words,
+            const std::vector<std::vector<uint32_t>> &shader_table
+        );
+
+        [[nodiscard]]
+        uint32_t get_subpass() const {
+            return subpass;
+        }
+
+    protected:
+        //
+        // Helpers
+        //
+
+        // Creates the set layouts first, nothing is leaked if the pipeline layout fails
+        VkPipelineLayout create_layout(VkDevice vk_device, std::vector<VkDescriptorSetLayout> &vk_set_layouts) const;
+
+        static void release_layout(VkDevice vk_device, VkPipelineLayout vk_pipeline_layout, const std::vector<VkDescriptorSetLayout> &vk_set_layouts);
+
+        static VkShaderModule create_module(VkDevice vk_device, const ShaderInfo &info);
+    };
+}
+
+#endif//MANA_VULKAN_PIPELINE_BUILDER_HPP
@@ -0,0 +1,267 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_pipeline_cache.hpp"
+
+#include <mana/internal/vulkan_instance.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <iostream>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanPipelineCache]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+using namespace ManaVK::Internal;
+
+VulkanPipelineCache::VulkanPipelineCache(VulkanInstance *vulkan_instance, const std::string &directory) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    VkPhysicalDeviceProperties vk_properties {};
+    vkGetPhysicalDeviceProperties(vulkan_instance->get_vk_gpu(), &vk_properties);
+
+    std::vector<char> data;
+
+    if (!directory.empty()) {
+        path = (std::filesystem::path(directory) / get_file_name(vk_properties)).string();
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+        if (file.is_open()) {
+            data.resize(static_cast<size_t>(file.tellg()));
+
+            file.seekg(0);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+            if (!file || !validate_header(data, vk_properties)) {
+                LOG("Warning: '" << path << "' isn't a valid cache for this device, starting cold");
+                data.clear();
+            }
+        }
+    }
+
+    create(vulkan_instance, data);
+}
+
+VulkanPipelineCache::VulkanPipelineCache(VulkanInstance *vulkan_instance, std::vector<char> data) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    create(vulkan_instance, data);
+}
+
+std::vector<char> VulkanPipelineCache::get_data(VulkanInstance *vulkan_instance) const {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+
+    size_t size = 0;
+    VkResult result = vkGetPipelineCacheData(vk_device, vk_pipeline_cache, &size, nullptr);
+
+    std::vector<char> data(size);
+
+    if (result == VK_SUCCESS) {
+        result = vkGetPipelineCacheData(vk_device, vk_pipeline_cache, &size, data.data());
+    }
+
+    if (result != VK_SUCCESS) {
+        LOG("vkGetPipelineCacheData failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkGetPipelineCacheData failed! Please check the log above for more info!");
+    }
+
+    data.resize(size);
+    return data;
+}
+
+void VulkanPipelineCache::merge(VulkanInstance *vulkan_instance, const std::vector<VulkanPipelineCache*> &sources) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    std::vector<VkPipelineCache> vk_sources;
+    for (auto source : sources) {
+        if (source != nullptr && source != this && source->vk_pipeline_cache != nullptr) {
+            vk_sources.push_back(source->vk_pipeline_cache);
+        }
+    }
+
+    if (vk_sources.empty()) {
+        return;
+    }
+
+    VkResult result = vkMergePipelineCaches(
+        vulkan_instance->get_vk_device(),
+        vk_pipeline_cache,
+        static_cast<uint32_t>(vk_sources.size()),
+        vk_sources.data()
+    );
+
+    if (result != VK_SUCCESS) {
+        LOG("vkMergePipelineCaches failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkMergePipelineCaches failed! Please check the log above for more info!");
+    }
+}
+
+void VulkanPipelineCache::create(VulkanInstance *vulkan_instance, std::vector<char> &data) {
+    VkPipelineCacheCreateInfo cache_info {};
+    {
+        cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+        cache_info.initialDataSize = data.size();
+        cache_info.pInitialData = data.empty() ? nullptr : data.data();
+    }
+
+    VkResult result = vkCreatePipelineCache(vulkan_instance->get_vk_device(), &cache_info, nullptr, &vk_pipeline_cache);
+
+    // Drivers are allowed to reject data even when the header matches, the cache is only an optimization
+    if (result != VK_SUCCESS && !data.empty()) {
+        LOG("Warning: The driver rejected the initial cache data, starting cold");
+
+        cache_info.initialDataSize = 0;
+        cache_info.pInitialData = nullptr;
+
+        data.clear();
+        result = vkCreatePipelineCache(vulkan_instance->get_vk_device(), &cache_info, nullptr, &vk_pipeline_cache);
+    }
+
+    if (result != VK_SUCCESS) {
+        LOG("vkCreatePipelineCache failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreatePipelineCache failed! Please check the log above for more info!");
+    }
+
+    warm = !data.empty();
+}
+
+void VulkanPipelineCache::save(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (path.empty() || vk_pipeline_cache == nullptr) {
+        return;
+    }
+
+    std::vector<char> data;
+
+    try {
+        data = get_data(vulkan_instance);
+    } catch (const std::runtime_error &) {
+        LOG("Warning: The cache couldn't be read back, it wasn't saved");
+        return;
+    }
+
+    std::filesystem::path target(path);
+    std::filesystem::path temporary(path + ".tmp");
+
+    std::error_code error;
+
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), error);
+    }
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+        if (!file) {
+            LOG("Warning: Couldn't write '" << temporary.string() << "', the cache wasn't saved");
+
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    // Replaces the old file in one step on both POSIX and Windows
+    std::filesystem::rename(temporary, target, error);
+
+    if (error) {
+        LOG("Warning: Couldn't replace '" << path << "' (" << error.message() << "), the cache wasn't saved");
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+void VulkanPipelineCache::release(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    if (vk_pipeline_cache != nullptr) {
+        vkDestroyPipelineCache(vulkan_instance->get_vk_device(), vk_pipeline_cache, nullptr);
+        vk_pipeline_cache = nullptr;
+    }
+}
+
+std::string VulkanPipelineCache::get_file_name(const VkPhysicalDeviceProperties &vk_properties) {
+    std::stringstream name;
+    name << std::hex << std::setfill('0');
+
+    name << "mana_pipelines_";
+    name << std::setw(8) << vk_properties.vendorID << "_";
+    name << std::setw(8) << vk_properties.deviceID << "_";
+    name << std::setw(8) << vk_properties.driverVersion << "_";
+
+    for (uint32_t b = 0; b < VK_UUID_SIZE; b++) {
+        name << std::setw(2) << static_cast<uint32_t>(vk_properties.pipelineCacheUUID[b]);
+    }
+
+    name << ".bin";
+    return name.str();
+}
+
+//
+// Helpers
+//
+bool VulkanPipelineCache::validate_header(const std::vector<char> &data, const VkPhysicalDeviceProperties &vk_properties) {
+    // VkPipelineCacheHeaderVersionOne, read field by field so padding and alignment don't matter
+    const size_t header_size = sizeof(uint32_t) * 4 + VK_UUID_SIZE;
+
+    if (data.size() < header_size) {
+        return false;
+    }
+
+    uint32_t fields[4];
+    std::memcpy(fields, data.data(), sizeof(fields));
+
+    if (fields[0] < header_size || fields[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) {
+        return false;
+    }
+
+    if (fields[2] != vk_properties.vendorID || fields[3] != vk_properties.deviceID) {
+        return false;
+    }
+
+    return std::memcmp(data.data() + sizeof(fields), vk_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
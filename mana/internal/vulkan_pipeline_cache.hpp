@@ -0,0 +1,100 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_PIPELINE_CACHE_HPP
+#define MANA_VULKAN_PIPELINE_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanInstance;
+
+    // Device wide VkPipelineCache that survives between runs
+    //
+    // The file name is made from the vendor, device, driver version and pipelineCacheUUID
+    // A driver update or a different GPU picks a new file instead of feeding the driver data it can't use
+    // The header is still checked on load, a copied or corrupt file is thrown away rather than trusted
+    //
+    // VkPipelineCache is internally synchronized, so any thread may build pipelines with it
+    class VulkanPipelineCache {
+    protected:
+        VkPipelineCache vk_pipeline_cache = nullptr;
+
+        // Empty when the cache only lives in memory
+        std::string path;
+
+        // True if the file existed and its data was handed to the driver
+        bool warm = false;
+
+        static bool validate_header(const std::vector<char> &data, const VkPhysicalDeviceProperties &vk_properties);
+
+        // Falls back to an empty cache if the driver refuses the data
+        void create(VulkanInstance *vulkan_instance, std::vector<char> &data);
+
+    public:
+        // An empty directory keeps the cache in memory, nothing is loaded or saved
+        VulkanPipelineCache(VulkanInstance *vulkan_instance, const std::string &directory);
+
+        // In memory only, starts with a copy of another cache's get_data()
+        VulkanPipelineCache(VulkanInstance *vulkan_instance, std::vector<char> data);
+
+        [[nodiscard]]
+        std::vector<char> get_data(VulkanInstance *vulkan_instance) const;
+
+        // Nothing may be building pipelines with this cache while merging, the sources are left untouched
+        void merge(VulkanInstance *vulkan_instance, const std::vector<VulkanPipelineCache*> &sources);
+
+        // Written to a temporary file and renamed over the old one, so a crash mid save can't leave a torn cache
+        // Failures are logged and otherwise ignored, the next run just starts cold
+        void save(VulkanInstance *vulkan_instance);
+
+        void release(VulkanInstance *vulkan_instance);
+
+        static std::string get_file_name(const VkPhysicalDeviceProperties &vk_properties);
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        VkPipelineCache get_vk_pipeline_cache() const {
+            return vk_pipeline_cache;
+        }
+
+        [[nodiscard]]
+        const std::string &get_path() const {
+            return path;
+        }
+
+        [[nodiscard]]
+        bool is_warm() const {
+            return warm;
+        }
+    };
+}
+
+#endif//MANA_VULKAN_PIPELINE_CACHE_HPP
@@ -0,0 +1,285 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_pipeline_compiler.hpp"
+
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_pipeline.hpp>
+#include <mana/internal/vulkan_pipeline_cache.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanPipelineCompiler]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+using namespace ManaVK::Internal;
+
+VulkanPipelineCompiler::VulkanPipelineCompiler(VulkanInstance *vulkan_instance, VulkanPipelineCache *seed, uint32_t thread_count) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    this->vulkan_instance = vulkan_instance;
+
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    // Every worker starts with what the main cache already knows, so warm starts stay warm
+    std::vector<char> seed_data;
+
+    if (seed != nullptr) {
+        seed_data = seed->get_data(vulkan_instance);
+    }
+
+    for (uint32_t w = 0; w < thread_count; w++) {
+        worker_caches.push_back(std::make_unique<VulkanPipelineCache>(vulkan_instance, seed_data));
+    }
+
+    for (uint32_t w = 0; w < thread_count; w++) {
+        workers.emplace_back(&VulkanPipelineCompiler::work, this, w);
+    }
+}
+
+void VulkanPipelineCompiler::set_recorder(VulkanPipelineRecorder *recorder) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->recorder = recorder;
+}
+
+std::vector<VulkanPipelineCompiler::Handle> VulkanPipelineCompiler::submit(std::vector<Job> jobs) {
+    std::vector<Handle> handles;
+    handles.reserve(jobs.size());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (stopping) {
+            throw std::runtime_error("Can't submit jobs to a released compiler!");
+        }
+
+        for (auto &job : jobs) {
+            auto &queue = job.priority == Priority::High ? high_jobs : low_jobs;
+
+            PendingJob pending;
+            {
+                pending.job = std::move(job);
+            }
+
+            handles.push_back(pending.promise.get_future().share());
+            queue.push_back(std::move(pending));
+        }
+    }
+
+    cv_work.notify_all();
+    return handles;
+}
+
+VulkanPipelineCompiler::Handle VulkanPipelineCompiler::submit(Job job) {
+    std::vector<Job> jobs;
+    jobs.push_back(std::move(job));
+
+    return submit(std::move(jobs))[0];
+}
+
+void VulkanPipelineCompiler::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    cv_idle.wait(lock, [this]() {
+        return active == 0 && high_jobs.empty() && low_jobs.empty();
+    });
+}
+
+void VulkanPipelineCompiler::merge(VulkanPipelineCache *target, bool share) {
+    if (target == nullptr) {
+        throw std::runtime_error("target was nullptr!");
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    merging = true;
+
+    cv_idle.wait(lock, [this]() {
+        return active == 0;
+    });
+
+    merge_workers(lock, target, share);
+}
+
+bool VulkanPipelineCompiler::try_merge(VulkanPipelineCache *target, bool share) {
+    if (target == nullptr) {
+        throw std::runtime_error("target was nullptr!");
+    }
+
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+
+    if (!lock.owns_lock() || merging || stopping || active != 0 || !high_jobs.empty() || !low_jobs.empty()) {
+        return false;
+    }
+
+    merging = true;
+
+    merge_workers(lock, target, share);
+    return true;
+}
+
+void VulkanPipelineCompiler::merge_workers(std::unique_lock<std::mutex> &lock, VulkanPipelineCache *target, bool share) {
+    std::vector<VulkanPipelineCache*> sources;
+    for (auto &cache : worker_caches) {
+        sources.push_back(cache.get());
+    }
+
+    try {
+        target->merge(vulkan_instance, sources);
+
+        if (share) {
+            for (auto &cache : worker_caches) {
+                cache->merge(vulkan_instance, {target});
+            }
+        }
+    } catch (...) {
+        merging = false;
+        cv_work.notify_all();
+        throw;
+    }
+
+    merging = false;
+    lock.unlock();
+
+    cv_work.notify_all();
+}
+
+void VulkanPipelineCompiler::release(VulkanPipelineCache *target) {
+    std::deque<PendingJob> dropped;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (stopping) {
+            return;
+        }
+
+        stopping = true;
+
+        dropped.swap(low_jobs);
+
+        for (auto &pending : high_jobs) {
+            dropped.push_back(std::move(pending));
+        }
+
+        high_jobs.clear();
+    }
+
+    cv_work.notify_all();
+    cv_idle.notify_all();
+
+    for (auto &pending : dropped) {
+        pending.promise.set_exception(std::make_exception_ptr(std::runtime_error("The pipeline compiler was released before this job ran!")));
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    workers.clear();
+
+    if (!dropped.empty()) {
+        LOG("Dropped " << dropped.size() << " pipeline(s) that were still queued");
+    }
+
+    if (target != nullptr) {
+        std::vector<VulkanPipelineCache*> sources;
+        for (auto &cache : worker_caches) {
+            sources.push_back(cache.get());
+        }
+
+        target->merge(vulkan_instance, sources);
+    }
+
+    for (auto &cache : worker_caches) {
+        cache->release(vulkan_instance);
+    }
+
+    worker_caches.clear();
+}
+
+//
+// Workers
+//
+void VulkanPipelineCompiler::work(uint32_t worker) {
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+    VulkanPipelineCache *cache = worker_caches[worker].get();
+
+    while (true) {
+        PendingJob pending;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            cv_work.wait(lock, [this]() {
+                return stopping || (!merging && (!high_jobs.empty() || !low_jobs.empty()));
+            });
+
+            if (stopping) {
+                return;
+            }
+
+            auto &queue = !high_jobs.empty() ? high_jobs : low_jobs;
+
+            pending = std::move(queue.front());
+            queue.pop_front();
+
+            active++;
+        }
+
+        VulkanPipelineRecorder *job_recorder = pending.job.warm_up ? nullptr : recorder;
+
+        try {
+            std::shared_ptr<VulkanPipeline> vulkan_pipeline;
+
+            if (pending.job.compute) {
+                vulkan_pipeline = pending.job.builder.build_compute(vk_device, cache, job_recorder);
+            } else {
+                vulkan_pipeline = pending.job.builder.build_graphics(vk_device, cache, job_recorder);
+            }
+
+            if (pending.job.warm_up) {
+                vulkan_pipeline->release(vk_device);
+                vulkan_pipeline = nullptr;
+            }
+
+            pending.promise.set_value(vulkan_pipeline);
+        } catch (...) {
+            pending.promise.set_exception(std::current_exception());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active--;
+        }
+
+        cv_idle.notify_all();
+    }
+}
@@ -0,0 +1,152 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_PIPELINE_COMPILER_HPP
+#define MANA_VULKAN_PIPELINE_COMPILER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mana/internal/vulkan_pipeline_builder.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanInstance;
+    class VulkanPipeline;
+    class VulkanPipelineCache;
+    class VulkanPipelineRecorder;
+
+    // Compiles pipelines on a pool of worker threads
+    //
+    // Each worker builds with its own VkPipelineCache, seeded from the main cache, so drivers never contend on one cache lock
+    // merge() folds whatever the workers compiled back into the main cache, release() does so one last time
+    // Until then the main cache (and every other worker) knows nothing about it, merge before relying on it
+    //
+    // High priority jobs are always picked before low priority ones
+    // Low priority permutations can keep compiling while the first frames are being rendered
+    class VulkanPipelineCompiler {
+    public:
+        enum class Priority {
+            High,
+            Low
+        };
+
+        struct Job {
+            // Copied into the job, but any render pass it references must stay alive until the job completes
+            VulkanPipelineBuilder builder;
+
+            bool compute = false;
+            Priority priority = Priority::High;
+
+            // Only warms the cache, the pipeline is destroyed once built and the handle yields null
+            bool warm_up = false;
+        };
+
+        // Build failures are rethrown by get()
+        using Handle = std::shared_future<std::shared_ptr<VulkanPipeline>>;
+
+    protected:
+        struct PendingJob {
+            Job job;
+            std::promise<std::shared_ptr<VulkanPipeline>> promise;
+        };
+
+        VulkanInstance *vulkan_instance = nullptr;
+        VulkanPipelineRecorder *recorder = nullptr;
+
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<VulkanPipelineCache>> worker_caches;
+
+        std::mutex mutex;
+        std::condition_variable cv_work;
+        std::condition_variable cv_idle;
+
+        std::deque<PendingJob> high_jobs;
+        std::deque<PendingJob> low_jobs;
+
+        // Jobs popped but not finished yet
+        uint32_t active = 0;
+
+        // Workers stop picking up jobs while their caches are being merged
+        bool merging = false;
+        bool stopping = false;
+
+        void work(uint32_t worker);
+
+        // Expects merging to be set and no jobs in flight, clears merging and wakes the workers when done
+        void merge_workers(std::unique_lock<std::mutex> &lock, VulkanPipelineCache *target, bool share);
+
+    public:
+        // A thread count of 0 uses every core but one, the main thread keeps the last
+        VulkanPipelineCompiler(VulkanInstance *vulkan_instance, VulkanPipelineCache *seed, uint32_t thread_count = 0);
+
+        // Every job built from now on is recorded, except warm-up jobs which came from a recording already
+        // Must be set before jobs are submitted
+        void set_recorder(VulkanPipelineRecorder *recorder);
+
+        // Thread safe, handles are in the same order as the jobs
+        std::vector<Handle> submit(std::vector<Job> jobs);
+        Handle submit(Job job);
+
+        // Blocks until every submitted job has completed
+        void wait_idle();
+
+        // Waits for in flight jobs, queued jobs stay queued until the merge is done
+        // Nothing else may be building pipelines with the target while merging
+        // Sharing merges the result back into every worker too, so each sees what the others compiled
+        void merge(VulkanPipelineCache *target, bool share = false);
+
+        // Same as merge(), but only if nothing is queued or compiling, returns false instead of waiting
+        // Meant for the frame path, call it again later when it fails
+        bool try_merge(VulkanPipelineCache *target, bool share = false);
+
+        // Jobs still queued fail with an exception, jobs in flight are finished first
+        // Merges into the target one last time if it isn't null
+        void release(VulkanPipelineCache *target);
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        uint32_t get_thread_count() const {
+            return static_cast<uint32_t>(workers.size());
+        }
+
+        // Jobs queued or compiling
+        [[nodiscard]]
+        size_t get_pending() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return high_jobs.size() + low_jobs.size() + active;
+        }
+    };
+}
+
+#endif//MANA_VULKAN_PIPELINE_COMPILER_HPP
@@ -0,0 +1,203 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_pipeline_family.hpp"
+
+#include <mana/internal/vulkan_pipeline.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <iostream>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanPipelineFamily]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+using namespace ManaVK::Internal;
+
+VulkanPipelineFamily::VulkanPipelineFamily(std::shared_ptr<VulkanPipeline> fallback) {
+    if (fallback == nullptr) {
+        throw std::runtime_error("fallback was nullptr!");
+    }
+
+    this->fallback = std::move(fallback);
+}
+
+VulkanPipelineFamily::Variant *VulkanPipelineFamily::request(VulkanPipelineCompiler *compiler, uint64_t key, VulkanPipelineCompiler::Job job) {
+    if (compiler == nullptr) {
+        throw std::runtime_error("compiler was nullptr!");
+    }
+
+    if (job.warm_up) {
+        throw std::runtime_error("Warm-up jobs can't be family variants, they don't yield a pipeline!");
+    }
+
+    bool compute = fallback->get_vk_bind_point() == VK_PIPELINE_BIND_POINT_COMPUTE;
+
+    if (job.compute != compute) {
+        throw std::runtime_error("Variants must have the same bind point as the fallback!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto iter = variants.find(key);
+
+    if (iter != variants.end()) {
+        return iter->second.get();
+    }
+
+    auto variant = std::make_unique<Variant>();
+    {
+        variant->handle = compiler->submit(std::move(job));
+    }
+
+    return variants.emplace(key, std::move(variant)).first->second.get();
+}
+
+VulkanPipeline *VulkanPipelineFamily::bind(VulkanCmdBuffer *vulkan_cmd_buffer, Variant *variant) {
+    VulkanPipeline *vulkan_pipeline = nullptr;
+
+    if (variant != nullptr) {
+        vulkan_pipeline = variant->ready.load(std::memory_order_acquire);
+
+        if (vulkan_pipeline == nullptr) {
+            vulkan_pipeline = poll(*variant);
+        }
+    }
+
+    if (vulkan_pipeline != nullptr) {
+        specialized_draws.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        vulkan_pipeline = fallback.get();
+        fallback_draws.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    vulkan_pipeline->bind(vulkan_cmd_buffer);
+    return vulkan_pipeline;
+}
+
+bool VulkanPipelineFamily::is_ready(Variant *variant) {
+    if (variant == nullptr) {
+        return false;
+    }
+
+    return poll(*variant) != nullptr;
+}
+
+VulkanPipelineFamily::Stats VulkanPipelineFamily::get_stats() {
+    Stats stats;
+    {
+        stats.specialized_draws = specialized_draws.load();
+        stats.fallback_draws = fallback_draws.load();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &[key, variant] : variants) {
+        if (poll(*variant) != nullptr) {
+            stats.variants_ready++;
+        } else if (variant->failed) {
+            stats.variants_failed++;
+        } else {
+            stats.variants_pending++;
+        }
+    }
+
+    return stats;
+}
+
+void VulkanPipelineFamily::reset_counters() {
+    specialized_draws = 0;
+    fallback_draws = 0;
+}
+
+void VulkanPipelineFamily::release(VkDevice vk_device) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<std::mutex> publish_lock(publish_mutex);
+
+    for (auto &[key, variant] : variants) {
+        if (variant->vulkan_pipeline == nullptr && !variant->failed) {
+            try {
+                variant->vulkan_pipeline = variant->handle.get();
+            } catch (...) {
+                variant->failed = true;
+            }
+        }
+
+        if (variant->vulkan_pipeline != nullptr) {
+            variant->vulkan_pipeline->release(vk_device);
+        }
+    }
+
+    variants.clear();
+
+    if (fallback != nullptr) {
+        fallback->release(vk_device);
+        fallback = nullptr;
+    }
+}
+
+//
+// Helpers
+//
+VulkanPipeline *VulkanPipelineFamily::poll(Variant &variant) {
+    VulkanPipeline *vulkan_pipeline = variant.ready.load(std::memory_order_acquire);
+
+    if (vulkan_pipeline != nullptr || variant.failed.load(std::memory_order_relaxed)) {
+        return vulkan_pipeline;
+    }
+
+    if (variant.handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(publish_mutex);
+
+    // Another thread may have published it while we waited for the lock
+    if (variant.vulkan_pipeline != nullptr || variant.failed) {
+        return variant.ready.load(std::memory_order_acquire);
+    }
+
+    // A failed variant keeps drawing with the fallback rather than taking the frame down, whatever was thrown
+    try {
+        variant.vulkan_pipeline = variant.handle.get();
+    } catch (const std::exception &exception) {
+        LOG("Warning: A variant failed to compile (" << exception.what() << "), using the fallback instead");
+        variant.failed = true;
+    } catch (...) {
+        LOG("Warning: A variant failed to compile, using the fallback instead");
+        variant.failed = true;
+    }
+
+    if (variant.vulkan_pipeline == nullptr) {
+        variant.failed = true;
+        return nullptr;
+    }
+
+    variant.ready.store(variant.vulkan_pipeline.get(), std::memory_order_release);
+    return variant.vulkan_pipeline.get();
+}
@@ -0,0 +1,128 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_PIPELINE_FAMILY_HPP
+#define MANA_VULKAN_PIPELINE_FAMILY_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mana/internal/vulkan_pipeline_compiler.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ManaVK::Internal {
+    class VulkanCmdBuffer;
+    class VulkanPipeline;
+
+    // A generic fallback pipeline plus specialized variants of it that compile in the background
+    //
+    // Draws bind the variant once it's ready and the fallback until then
+    // So a variant still compiling costs a little quality or speed for a few frames instead of a frozen frame
+    //
+    // Variants must use a layout compatible with the fallback's, descriptor sets bound for one are then valid for the other
+    class VulkanPipelineFamily {
+    public:
+        struct Stats {
+            uint64_t specialized_draws = 0;
+            uint64_t fallback_draws = 0;
+
+            uint32_t variants_ready = 0;
+            uint32_t variants_pending = 0;
+            uint32_t variants_failed = 0;
+        };
+
+        // Returned by request(), lives as long as the family
+        class Variant {
+            friend class VulkanPipelineFamily;
+
+        protected:
+            VulkanPipelineCompiler::Handle handle;
+
+            // Keeps the pipeline alive, written once before ready is published
+            std::shared_ptr<VulkanPipeline> vulkan_pipeline = nullptr;
+
+            // Published once the handle is ready, binds read it without taking any lock
+            std::atomic<VulkanPipeline*> ready = nullptr;
+            std::atomic<bool> failed = false;
+        };
+
+    protected:
+        std::shared_ptr<VulkanPipeline> fallback = nullptr;
+
+        // Guards the variant table, never taken by bind()
+        std::mutex mutex;
+        std::unordered_map<uint64_t, std::unique_ptr<Variant>> variants;
+
+        // Taken once per variant, by whichever thread first sees its handle become ready
+        std::mutex publish_mutex;
+
+        // Atomic so forked workers can count draws without a lock
+        std::atomic<uint64_t> specialized_draws = 0;
+        std::atomic<uint64_t> fallback_draws = 0;
+
+        // Returns null while the variant is compiling or if it failed
+        VulkanPipeline *poll(Variant &variant);
+
+    public:
+        // The fallback should be built up front, with VulkanPipelineBuilder directly
+        VulkanPipelineFamily(std::shared_ptr<VulkanPipeline> fallback);
+
+        // Thread safe, submits the variant to the compiler unless the key was already requested
+        // The same key always returns the same variant
+        Variant *request(VulkanPipelineCompiler *compiler, uint64_t key, VulkanPipelineCompiler::Job job);
+
+        // Thread safe and lock free once the variant is ready, binds it if it finished compiling and the fallback otherwise
+        // A null variant binds the fallback
+        // Returns what was bound, so push constants and descriptor sets go through its layout
+        VulkanPipeline *bind(VulkanCmdBuffer *vulkan_cmd_buffer, Variant *variant);
+
+        [[nodiscard]]
+        bool is_ready(Variant *variant);
+
+        // Draw counts are since the last reset_counters(), variant counts are current
+        [[nodiscard]]
+        Stats get_stats();
+
+        void reset_counters();
+
+        // Waits for variants still compiling, release the compiler first to have its queued jobs dropped instead
+        // The GPU must be done with every pipeline in the family
+        void release(VkDevice vk_device);
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        VulkanPipeline *get_fallback() const {
+            return fallback.get();
+        }
+    };
+}
+
+#endif//MANA_VULKAN_PIPELINE_FAMILY_HPP
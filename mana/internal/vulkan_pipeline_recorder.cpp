@@ -0,0 +1,293 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_pipeline_recorder.hpp"
+
+#include <mana/internal/vulkan_pipeline_builder.hpp>
+#include <mana/internal/vulkan_render_pass_cache.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <iostream>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanPipelineRecorder]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+using namespace ManaVK::Internal;
+
+VulkanPipelineRecorder::VulkanPipelineRecorder(const std::string &path) {
+    if (path.empty()) {
+        throw std::runtime_error("path was empty!");
+    }
+
+    this->path = path;
+
+    if (std::filesystem::exists(path) && !load()) {
+        LOG("Warning: '" << path << "' isn't a valid pipeline manifest, starting a new one");
+
+        shaders.clear();
+        entries.clear();
+        shader_lookup.clear();
+        entry_lookup.clear();
+    }
+}
+
+void VulkanPipelineRecorder::record(const VulkanPipelineBuilder &builder, bool compute) {
+    if (builder.get_subpass() != 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Entry entry;
+    {
+        entry.compute = compute;
+
+        builder.write_description(entry.words, [this](const std::vector<uint32_t> &spirv) {
+            return intern_shader(spirv);
+        });
+    }
+
+    if (insert_entry(std::move(entry))) {
+        dirty = true;
+    }
+}
+
+std::vector<VulkanPipelineCompiler::Job> VulkanPipelineRecorder::get_replay_jobs(VkDevice vk_device, VulkanRenderPassCache *render_pass_cache) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<VulkanPipelineCompiler::Job> jobs;
+    jobs.reserve(entries.size());
+
+    size_t skipped = 0;
+
+    for (const auto &entry : entries) {
+        VulkanPipelineCompiler::Job job;
+        {
+            job.compute = entry.compute;
+            job.priority = VulkanPipelineCompiler::Priority::Low;
+            job.warm_up = true;
+        }
+
+        if (!job.builder.read_description(vk_device, render_pass_cache, entry.words, shaders)) {
+            skipped++;
+            continue;
+        }
+
+        jobs.push_back(std::move(job));
+    }
+
+    if (skipped > 0) {
+        LOG("Warning: Skipped " << skipped << " pipeline(s) in '" << path << "' that couldn't be read");
+    }
+
+    return jobs;
+}
+
+void VulkanPipelineRecorder::save() {
+    std::vector<uint32_t> words;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!dirty) {
+            return;
+        }
+
+        words.push_back(MANIFEST_MAGIC);
+        words.push_back(MANIFEST_VERSION);
+
+        words.push_back(static_cast<uint32_t>(shaders.size()));
+        for (const auto &spirv : shaders) {
+            words.push_back(static_cast<uint32_t>(spirv.size()));
+            words.insert(words.end(), spirv.begin(), spirv.end());
+        }
+
+        words.push_back(static_cast<uint32_t>(entries.size()));
+        for (const auto &entry : entries) {
+            words.push_back(entry.compute);
+            words.push_back(static_cast<uint32_t>(entry.words.size()));
+            words.insert(words.end(), entry.words.begin(), entry.words.end());
+        }
+
+        dirty = false;
+    }
+
+    std::filesystem::path target(path);
+    std::filesystem::path temporary(path + ".tmp");
+
+    std::error_code error;
+
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), error);
+    }
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+
+        if (!file) {
+            LOG("Warning: Couldn't write '" << temporary.string() << "', the manifest wasn't saved");
+
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, target, error);
+
+    if (error) {
+        LOG("Warning: Couldn't replace '" << path << "' (" << error.message() << "), the manifest wasn't saved");
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+//
+// Helpers
+//
+bool VulkanPipelineRecorder::load() {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    auto size = static_cast<size_t>(file.tellg());
+
+    if (size % sizeof(uint32_t) != 0) {
+        return false;
+    }
+
+    std::vector<uint32_t> words(size / sizeof(uint32_t));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(size));
+
+    if (!file) {
+        return false;
+    }
+
+    size_t cursor = 0;
+
+    // Any length has to fit in what's left of the file
+    auto read_block = [&words, &cursor](std::vector<uint32_t> &block) {
+        if (cursor >= words.size()) {
+            return false;
+        }
+
+        uint32_t count = words[cursor++];
+
+        if (count > words.size() - cursor) {
+            return false;
+        }
+
+        block.assign(words.begin() + cursor, words.begin() + cursor + count);
+        cursor += count;
+
+        return true;
+    };
+
+    if (words.size() < 3 || words[0] != MANIFEST_MAGIC || words[1] != MANIFEST_VERSION) {
+        return false;
+    }
+
+    cursor = 2;
+
+    uint32_t shader_count = words[cursor++];
+    for (uint32_t s = 0; s < shader_count; s++) {
+        std::vector<uint32_t> spirv;
+
+        if (!read_block(spirv)) {
+            return false;
+        }
+
+        // Not interned, pipelines refer to shaders by their position in the file
+        shader_lookup.emplace(VulkanRenderPassCache::hash_words(spirv), s);
+        shaders.push_back(std::move(spirv));
+    }
+
+    if (cursor >= words.size()) {
+        return false;
+    }
+
+    uint32_t entry_count = words[cursor++];
+    for (uint32_t e = 0; e < entry_count; e++) {
+        if (cursor >= words.size()) {
+            return false;
+        }
+
+        Entry entry;
+        entry.compute = words[cursor++] != 0;
+
+        if (!read_block(entry.words)) {
+            return false;
+        }
+
+        insert_entry(std::move(entry));
+    }
+
+    return cursor == words.size();
+}
+
+uint32_t VulkanPipelineRecorder::intern_shader(const std::vector<uint32_t> &spirv) {
+    uint64_t hash = VulkanRenderPassCache::hash_words(spirv);
+
+    auto range = shader_lookup.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; iter++) {
+        if (shaders[iter->second] == spirv) {
+            return iter->second;
+        }
+    }
+
+    auto index = static_cast<uint32_t>(shaders.size());
+
+    shaders.push_back(spirv);
+    shader_lookup.emplace(hash, index);
+
+    return index;
+}
+
+bool VulkanPipelineRecorder::insert_entry(Entry entry) {
+    uint64_t hash = VulkanRenderPassCache::hash_words(entry.words) ^ static_cast<uint64_t>(entry.compute);
+
+    auto range = entry_lookup.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; iter++) {
+        const Entry &existing = entries[iter->second];
+
+        if (existing.compute == entry.compute && existing.words == entry.words) {
+            return false;
+        }
+    }
+
+    entry_lookup.emplace(hash, static_cast<uint32_t>(entries.size()));
+    entries.push_back(std::move(entry));
+
+    return true;
+}
@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_PIPELINE_RECORDER_HPP
+#define MANA_VULKAN_PIPELINE_RECORDER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mana/internal/vulkan_pipeline_compiler.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanPipelineBuilder;
+    class VulkanRenderPassCache;
+
+    // Keeps a manifest of every pipeline description built, so later runs can compile them all up front
+    //
+    // The manifest is a flat list of words, SPIR-V is stored once no matter how many pipelines use it
+    //  magic, version
+    //  shader count, (word count, SPIR-V)...
+    //  pipeline count, (compute, word count, VulkanPipelineBuilder::write_description())...
+    //
+    // Replaying only warms the VkPipelineCache, the pipelines built are thrown away
+    // The real build later on is then a cache hit instead of a compile on the frame path
+    class VulkanPipelineRecorder {
+    public:
+        static constexpr uint32_t MANIFEST_MAGIC = 0x4F53504D; // "MPSO"
+        static constexpr uint32_t MANIFEST_VERSION = 1;
+
+    protected:
+        struct Entry {
+            bool compute = false;
+            std::vector<uint32_t> words;
+        };
+
+        std::mutex mutex;
+        std::string path;
+
+        std::vector<std::vector<uint32_t>> shaders;
+        std::vector<Entry> entries;
+
+        // Hash to index, collisions are told apart by comparing the words
+        std::unordered_multimap<uint64_t, uint32_t> shader_lookup;
+        std::unordered_multimap<uint64_t, uint32_t> entry_lookup;
+
+        // Set when something was recorded since the last save()
+        bool dirty = false;
+
+        // Returns false if the file was missing or malformed, nothing is kept from a malformed file
+        bool load();
+
+        // The mutex must be held
+        uint32_t intern_shader(const std::vector<uint32_t> &spirv);
+        bool insert_entry(Entry entry);
+
+    public:
+        // Loads the manifest at path if there is one
+        VulkanPipelineRecorder(const std::string &path);
+
+        // Thread safe, descriptions already in the manifest are ignored
+        // Pipelines using a subpass other than the first can't be replayed, so they aren't recorded
+        void record(const VulkanPipelineBuilder &builder, bool compute);
+
+        // Low priority warm-up jobs for every recorded pipeline, descriptions that fail to read are skipped
+        std::vector<VulkanPipelineCompiler::Job> get_replay_jobs(VkDevice vk_device, VulkanRenderPassCache *render_pass_cache);
+
+        // Written to a temporary file and renamed over the old one, does nothing if nothing new was recorded
+        void save();
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        size_t get_size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries.size();
+        }
+
+        [[nodiscard]]
+        const std::string &get_path() const {
+            return path;
+        }
+    };
+}
+
+#endif//MANA_VULKAN_PIPELINE_RECORDER_HPP
@@ -49,65 +49,253 @@ void Internal::VulkanQueue::warm_queue(VkInstance vk_instance, VkDevice vk_devic
         throw std::runtime_error("vk_device was nullptr!");
     }
 
-    vkGetDeviceQueue(vk_device, index, 0, &vk_queue);
+    vkGetDeviceQueue(vk_device, index, slot, &vk_queue);
 
     if (vk_queue == nullptr) {
         throw std::runtime_error("vkGetDeviceQueue failed!");
     }
+}
 
-    uint32_t flags;
-    switch (type) {
-        default:
-            flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-            break;
+std::unique_ptr<Internal::VulkanCmdPool> Internal::VulkanQueue::create_cmd_pool(VkDevice vk_device, const VulkanCmdPool::PoolConfig &config) {
+    if (vk_queue == nullptr) {
+        throw std::runtime_error("Queue wasn't warmed yet!");
+    }
+
+    return std::make_unique<VulkanCmdPool>(vk_device, this, config);
+}
+
+void Internal::VulkanQueue::create_timeline(VkDevice vk_device) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
 
-        case Type::Transfer:
-            flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-            break;
+    if (vk_timeline != nullptr) {
+        throw std::runtime_error("Queue timeline was already created!");
     }
 
-    VkCommandPoolCreateInfo pool_create_info{};
+    VkSemaphoreTypeCreateInfo type_create_info {};
+    {
+        type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+
+        type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        type_create_info.initialValue = 0;
+    }
 
-    pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    pool_create_info.flags = flags;
-    pool_create_info.queueFamilyIndex = index;
+    VkSemaphoreCreateInfo create_info {};
+    {
+        create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        create_info.pNext = &type_create_info;
+    }
 
-    VkResult result = vkCreateCommandPool(vk_device, &pool_create_info, nullptr, &vk_cmd_pool);
+    VkResult result = vkCreateSemaphore(vk_device, &create_info, nullptr, &vk_timeline);
 
     if (result != VK_SUCCESS) {
-        LOG("Error: vkCreateCommandPool failed with error code (" << string_VkResult(result) << ")");
-        throw std::runtime_error("vkCreateCommandPool failed! Please check the log above for more info!");
+        LOG("Error: vkCreateSemaphore failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkCreateSemaphore failed! Please check the log above for more info!");
     }
+
+    timeline_value = 0;
 }
 
-Internal::VulkanCmdBuffer *Internal::VulkanQueue::allocate_cmd_buffer(VkDevice vk_device) {
-    if (vk_device == nullptr) {
-        throw std::runtime_error("vk_device was nullptr!");
+void Internal::VulkanQueue::release_timeline(VkDevice vk_device) {
+    if (vk_timeline != nullptr) {
+        if (vk_device == nullptr) {
+            throw std::runtime_error("vk_device was nullptr!");
+        }
+
+        vkDestroySemaphore(vk_device, vk_timeline, nullptr);
+        vk_timeline = nullptr;
     }
+}
 
-    VkCommandBufferAllocateInfo alloc_info{};
-    {
-        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+//
+// Submission
+//
+Internal::VulkanScheduler::TimelinePoint Internal::VulkanQueue::enqueue_submit(VkCommandBuffer vk_cmd_buffer, const VulkanCmdBuffer::SubmitInfo &info) {
+    if (vk_cmd_buffer == nullptr) {
+        throw std::runtime_error("vk_cmd_buffer was nullptr!");
+    }
 
-        alloc_info.commandPool = vk_cmd_pool;
-        alloc_info.commandBufferCount = 1;
+    if (info.vk_wait_flags.size() < info.vk_wait_semaphores.size()) {
+        throw std::runtime_error("Every wait semaphore needs matching wait flags!");
+    }
 
-        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    // Other queues must have the work we wait on in flight, otherwise we'd wait on something that's still batched
+    // This happens outside our lock so two queues waiting on each other can't deadlock
+    for (const auto& wait : info.timeline_waits) {
+        if (wait.point.is_valid() && wait.point.vulkan_queue != this) {
+            wait.point.vulkan_queue->flush_submits(wait.point.value);
+        }
     }
 
-    VkCommandBuffer vk_buffer = nullptr;
-    VkResult result = vkAllocateCommandBuffers(vk_device, &alloc_info, &vk_buffer);
+    std::lock_guard<std::mutex> lock(submit_mutex);
 
-    if (result != VK_SUCCESS) {
-        LOG("vkAllocateCommandBuffers failed with error code (" << string_VkResult(result) << ")");
-        throw std::runtime_error("vkAllocateCommandBuffers failed! Please check the log above for more info!");
+    VulkanScheduler::TimelinePoint signal_point;
+    {
+        signal_point.vulkan_queue = this;
+        signal_point.value = advance_timeline();
+    }
+
+    bool has_waits = !info.vk_wait_semaphores.empty();
+    for (const auto& wait : info.timeline_waits) {
+        has_waits |= wait.point.is_valid();
+    }
+
+    bool has_binary_signals = !info.vk_signal_semaphores.empty();
+
+    //
+    // Merging
+    //
+    // Work with nothing to wait on can ride along with the previous submission
+    // Only the final timeline value is signaled, which also satisfies anyone waiting on the values in between
+    if (!has_waits && !pending_submits.empty() && pending_submits.back().mergeable) {
+        PendingSubmit &last = pending_submits.back();
+
+        pending_cmd_buffers.push_back(vk_cmd_buffer);
+        last.cmd_count++;
+
+        pending_signal_values[last.signal_offset + last.signal_count - 1] = signal_point.value;
+
+        for (auto vk_semaphore : info.vk_signal_semaphores) {
+            pending_signal_semaphores.insert(pending_signal_semaphores.begin() + last.signal_offset + last.signal_count - 1, vk_semaphore);
+            pending_signal_values.insert(pending_signal_values.begin() + last.signal_offset + last.signal_count - 1, 0);
+            last.signal_count++;
+        }
+
+        last.mergeable = !has_binary_signals;
+        return signal_point;
     }
 
-    VulkanCmdBuffer::BufferConfig config;
+    PendingSubmit pending;
     {
-        config.vk_cmd_buffer = vk_buffer;
-        // TODO: Change flags (when necessary)
+        // Anything merged in later would inherit our waits, so work that waits stays on its own
+        pending.mergeable = !has_binary_signals && !has_waits;
+
+        //
+        // Waits
+        //
+        // Binary and timeline semaphores share the same arrays, binary values are ignored by the driver
+        pending.wait_offset = static_cast<uint32_t>(pending_wait_semaphores.size());
+
+        for (size_t w = 0; w < info.vk_wait_semaphores.size(); w++) {
+            pending_wait_semaphores.push_back(info.vk_wait_semaphores[w]);
+            pending_wait_flags.push_back(info.vk_wait_flags[w]);
+            pending_wait_values.push_back(0);
+        }
+
+        for (const auto& wait : info.timeline_waits) {
+            if (!wait.point.is_valid()) {
+                continue;
+            }
+
+            pending_wait_semaphores.push_back(wait.point.vulkan_queue->get_vk_timeline());
+            pending_wait_flags.push_back(wait.vk_stage_flags);
+            pending_wait_values.push_back(wait.point.value);
+        }
+
+        pending.wait_count = static_cast<uint32_t>(pending_wait_semaphores.size()) - pending.wait_offset;
+
+        //
+        // Signals
+        //
+        // Our own timeline always comes last, merging relies on that
+        pending.signal_offset = static_cast<uint32_t>(pending_signal_semaphores.size());
+
+        for (auto vk_semaphore : info.vk_signal_semaphores) {
+            pending_signal_semaphores.push_back(vk_semaphore);
+            pending_signal_values.push_back(0);
+        }
+
+        pending_signal_semaphores.push_back(vk_timeline);
+        pending_signal_values.push_back(signal_point.value);
+
+        pending.signal_count = static_cast<uint32_t>(pending_signal_semaphores.size()) - pending.signal_offset;
+
+        //
+        // Command buffers
+        //
+        pending.cmd_offset = static_cast<uint32_t>(pending_cmd_buffers.size());
+        pending.cmd_count = 1;
+
+        pending_cmd_buffers.push_back(vk_cmd_buffer);
+    }
+
+    pending_submits.push_back(pending);
+    return signal_point;
+}
+
+void Internal::VulkanQueue::flush_submits() {
+    std::lock_guard<std::mutex> lock(submit_mutex);
+    flush_submits_locked();
+}
+
+VkResult Internal::VulkanQueue::present(const VkPresentInfoKHR &info) {
+    // Vulkan requires presents to be externally synchronized with submits to the same VkQueue
+    std::lock_guard<std::mutex> lock(submit_mutex);
+    flush_submits_locked();
+
+    return vkQueuePresentKHR(vk_queue, &info);
+}
+
+void Internal::VulkanQueue::flush_submits_locked() {
+    if (pending_submits.empty()) {
+        return;
+    }
+
+    vk_submit_infos.resize(pending_submits.size());
+    vk_timeline_infos.resize(pending_submits.size());
+
+    for (size_t s = 0; s < pending_submits.size(); s++) {
+        const PendingSubmit &pending = pending_submits[s];
+
+        VkTimelineSemaphoreSubmitInfo &timeline_info = vk_timeline_infos[s];
+        timeline_info = {};
+        {
+            timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+
+            timeline_info.waitSemaphoreValueCount = pending.wait_count;
+            timeline_info.pWaitSemaphoreValues = pending_wait_values.data() + pending.wait_offset;
+
+            timeline_info.signalSemaphoreValueCount = pending.signal_count;
+            timeline_info.pSignalSemaphoreValues = pending_signal_values.data() + pending.signal_offset;
+        }
+
+        VkSubmitInfo &submit_info = vk_submit_infos[s];
+        submit_info = {};
+        {
+            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.pNext = &timeline_info;
+
+            submit_info.waitSemaphoreCount = pending.wait_count;
+            submit_info.pWaitSemaphores = pending_wait_semaphores.data() + pending.wait_offset;
+            submit_info.pWaitDstStageMask = pending_wait_flags.data() + pending.wait_offset;
+
+            submit_info.signalSemaphoreCount = pending.signal_count;
+            submit_info.pSignalSemaphores = pending_signal_semaphores.data() + pending.signal_offset;
+
+            submit_info.commandBufferCount = pending.cmd_count;
+            submit_info.pCommandBuffers = pending_cmd_buffers.data() + pending.cmd_offset;
+        }
     }
 
-    return new VulkanCmdBuffer(config, this);
-}
\ No newline at end of file
+    // Batches are executed in order, so the timeline is still signaled in increasing order
+    VkResult result = vkQueueSubmit(vk_queue, static_cast<uint32_t>(vk_submit_infos.size()), vk_submit_infos.data(), nullptr);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkQueueSubmit failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkQueueSubmit failed! Please check the log above for more info!");
+    }
+
+    flushed_value = timeline_value.load();
+
+    pending_submits.clear();
+
+    pending_wait_semaphores.clear();
+    pending_wait_flags.clear();
+    pending_wait_values.clear();
+
+    pending_signal_semaphores.clear();
+    pending_signal_values.clear();
+
+    pending_cmd_buffers.clear();
+}
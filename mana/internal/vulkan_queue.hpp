@@ -27,37 +27,122 @@ SOFTWARE.
 
 #include <vulkan/vulkan.h>
 
+#include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_cmd_pool.hpp>
+#include <mana/internal/vulkan_scheduler.hpp>
+
 #include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace ManaVK::Internal {
     class VulkanCmdBuffer;
 
+    // Submissions aren't sent to the driver right away, they're batched per queue
+    // flush_submits() then hands everything to a single vkQueueSubmit, in the order it was enqueued
+    // Anything that depends on the GPU seeing the work (present, CPU waits, other queues) flushes first
     class VulkanQueue {
     public:
         enum class Type {
             Graphics,
             Transfer,
-            Present
+            Present,
 
-            // TODO: Compute queue?
+            // Prefers a family without graphics support, so work on it can overlap raster work
+            Compute
         };
 
     protected:
         Type type;
         uint32_t index;
+
+        // Which of the family's queues this is, two VulkanQueues never share a VkQueue
+        uint32_t slot = 0;
+
         VkQueue vk_queue = nullptr;
-        VkCommandPool vk_cmd_pool = nullptr;
+
+        // Signaled by every submission made to this queue, see VulkanScheduler
+        VkSemaphore vk_timeline = nullptr;
+        std::atomic<uint64_t> timeline_value {0};
+        std::atomic<uint64_t> flushed_value {0};
+
+        // Offsets into the flat arrays below, kept as offsets since the arrays grow while batching
+        struct PendingSubmit {
+            uint32_t wait_offset = 0;
+            uint32_t wait_count = 0;
+
+            uint32_t signal_offset = 0;
+            uint32_t signal_count = 0;
+
+            uint32_t cmd_offset = 0;
+            uint32_t cmd_count = 0;
+
+            // Binary signals (swapchain) or waits mean later work can't be folded into this submission
+            bool mergeable = false;
+        };
+
+        // Guards everything below along with the timeline value, so values are signaled in submission order
+        std::mutex submit_mutex;
+
+        std::vector<PendingSubmit> pending_submits;
+
+        std::vector<VkSemaphore> pending_wait_semaphores;
+        std::vector<VkPipelineStageFlags> pending_wait_flags;
+        std::vector<uint64_t> pending_wait_values;
+
+        std::vector<VkSemaphore> pending_signal_semaphores;
+        std::vector<uint64_t> pending_signal_values;
+
+        std::vector<VkCommandBuffer> pending_cmd_buffers;
+
+        // Scratch space for flushing, kept around so a flush doesn't allocate
+        std::vector<VkSubmitInfo> vk_submit_infos;
+        std::vector<VkTimelineSemaphoreSubmitInfo> vk_timeline_infos;
+
+        // Reserves the value the next submission will signal
+        uint64_t advance_timeline() {
+            return ++timeline_value;
+        }
+
+        void flush_submits_locked();
 
     public:
         VulkanQueue() = delete;
-        VulkanQueue(Type type, uint32_t index) {
+        VulkanQueue(Type type, uint32_t index, uint32_t slot = 0) {
             this->type = type;
             this->index = index;
+            this->slot = slot;
         }
 
         void warm_queue(VkInstance vk_instance, VkDevice vk_device);
 
-        VulkanCmdBuffer *allocate_cmd_buffer(VkDevice vk_device);
+        // Pools are owned by whoever records with them, usually one per thread per frame slot
+        std::unique_ptr<VulkanCmdPool> create_cmd_pool(VkDevice vk_device, const VulkanCmdPool::PoolConfig &config = {});
+
+        void create_timeline(VkDevice vk_device);
+        void release_timeline(VkDevice vk_device);
+
+        //
+        // Submission
+        //
+
+        // Thread safe, returns the point the buffer will have finished executing at
+        VulkanScheduler::TimelinePoint enqueue_submit(VkCommandBuffer vk_cmd_buffer, const VulkanCmdBuffer::SubmitInfo &info);
+
+        // Thread safe, sends every pending submission to the GPU
+        void flush_submits();
+
+        // Thread safe, flushes first so the semaphores being waited on have been submitted
+        VkResult present(const VkPresentInfoKHR &info);
+
+        // Flushes only if the value hasn't been handed to the GPU yet
+        void flush_submits(uint64_t value) {
+            if (value > flushed_value) {
+                flush_submits();
+            }
+        }
 
     public:
         [[nodiscard]]
@@ -70,10 +155,32 @@ namespace ManaVK::Internal {
             return index;
         }
 
+        [[nodiscard]]
+        uint32_t get_slot() const {
+            return slot;
+        }
+
         [[nodiscard]]
         VkQueue get_vk_queue() const {
             return vk_queue;
         }
+
+        [[nodiscard]]
+        VkSemaphore get_vk_timeline() const {
+            return vk_timeline;
+        }
+
+        // The last value handed out to a submission, not necessarily completed yet!
+        [[nodiscard]]
+        uint64_t get_timeline_value() const {
+            return timeline_value;
+        }
+
+        // The last value actually handed to the GPU, everything past this is still batched
+        [[nodiscard]]
+        uint64_t get_flushed_value() const {
+            return flushed_value;
+        }
     };
 }
 
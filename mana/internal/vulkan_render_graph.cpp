@@ -0,0 +1,891 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_render_graph.hpp"
+
+#include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_framebuffer_cache.hpp>
+#include <mana/internal/vulkan_image.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_render_pass_builder.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <iostream>
+
+using namespace ManaVK::Internal;
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanRenderGraph]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+VulkanRenderGraph::Compiled::~Compiled() = default;
+
+//
+// Declaration
+//
+VulkanRenderGraph::ResourceHandle VulkanRenderGraph::create_image(const std::string &name, const ImageDesc &desc) {
+    if (desc.vk_format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("Graph image '" + name + "' has an undefined format!");
+    }
+
+    if (desc.scale <= 0.0f) {
+        throw std::runtime_error("Graph image '" + name + "' has a scale of 0 or less!");
+    }
+
+    Resource resource;
+    {
+        resource.name = name;
+        resource.desc = desc;
+    }
+
+    resources.emplace_back(std::move(resource));
+    dirty = true;
+
+    return static_cast<ResourceHandle>(resources.size() - 1);
+}
+
+VulkanRenderGraph::ResourceHandle VulkanRenderGraph::import_target(const std::string &name) {
+    for (const auto &resource : resources) {
+        if (resource.imported) {
+            throw std::runtime_error("A graph can only import a single target!");
+        }
+    }
+
+    Resource resource;
+    {
+        resource.name = name;
+        resource.imported = true;
+        resource.output = true;
+    }
+
+    resources.emplace_back(std::move(resource));
+    dirty = true;
+
+    return static_cast<ResourceHandle>(resources.size() - 1);
+}
+
+void VulkanRenderGraph::mark_output(ResourceHandle resource) {
+    resources.at(resource).output = true;
+    dirty = true;
+}
+
+VulkanRenderGraph::PassHandle VulkanRenderGraph::add_pass(const std::string &name) {
+    Pass pass;
+    {
+        pass.name = name;
+    }
+
+    passes.emplace_back(std::move(pass));
+    dirty = true;
+
+    return static_cast<PassHandle>(passes.size() - 1);
+}
+
+void VulkanRenderGraph::write_color(PassHandle pass, ResourceHandle resource, const VkClearColorValue *clear) {
+    Pass &target_pass = passes.at(pass);
+    Resource &target_resource = resources.at(resource);
+
+    if (target_resource.imported) {
+        for (const auto &other : passes) {
+            if (other.writes_target && &other != &target_pass) {
+                throw std::runtime_error("Only one pass may write the target! '" + other.name + "' already does!");
+            }
+        }
+
+        // The target's own render pass decides how it's loaded and cleared
+        target_pass.writes_target = true;
+        dirty = true;
+
+        return;
+    }
+
+    if (target_resource.desc.depth) {
+        throw std::runtime_error("'" + target_resource.name + "' is a depth image! Use write_depth() instead!");
+    }
+
+    for (auto read : target_pass.reads) {
+        if (read == resource) {
+            throw std::runtime_error("Pass '" + target_pass.name + "' can't read and write '" + target_resource.name + "'!");
+        }
+    }
+
+    Attachment attachment;
+    {
+        attachment.resource = resource;
+
+        if (clear != nullptr) {
+            attachment.clear = true;
+            attachment.vk_clear_value.color = *clear;
+        }
+    }
+
+    target_pass.color_writes.push_back(attachment);
+    dirty = true;
+}
+
+void VulkanRenderGraph::write_depth(PassHandle pass, ResourceHandle resource, const VkClearDepthStencilValue *clear) {
+    Pass &target_pass = passes.at(pass);
+    Resource &target_resource = resources.at(resource);
+
+    if (target_resource.imported || !target_resource.desc.depth) {
+        throw std::runtime_error("'" + target_resource.name + "' isn't a depth image!");
+    }
+
+    for (auto read : target_pass.reads) {
+        if (read == resource) {
+            throw std::runtime_error("Pass '" + target_pass.name + "' can't read and write '" + target_resource.name + "'!");
+        }
+    }
+
+    Attachment attachment;
+    {
+        attachment.resource = resource;
+
+        if (clear != nullptr) {
+            attachment.clear = true;
+            attachment.vk_clear_value.depthStencil = *clear;
+        }
+    }
+
+    target_pass.depth_write = attachment;
+    dirty = true;
+}
+
+void VulkanRenderGraph::read(PassHandle pass, ResourceHandle resource) {
+    Pass &target_pass = passes.at(pass);
+    Resource &target_resource = resources.at(resource);
+
+    if (target_resource.imported) {
+        throw std::runtime_error("The target can't be read by the graph!");
+    }
+
+    bool writes = target_pass.depth_write.resource == resource;
+    for (const auto &attachment : target_pass.color_writes) {
+        writes |= attachment.resource == resource;
+    }
+
+    if (writes) {
+        throw std::runtime_error("Pass '" + target_pass.name + "' can't read and write '" + target_resource.name + "'!");
+    }
+
+    target_pass.reads.push_back(resource);
+    dirty = true;
+}
+
+void VulkanRenderGraph::set_side_effects(PassHandle pass) {
+    passes.at(pass).side_effects = true;
+    dirty = true;
+}
+
+void VulkanRenderGraph::clear() {
+    resources.clear();
+    passes.clear();
+    schedule.clear();
+
+    dirty = true;
+}
+
+//
+// Compilation
+//
+void VulkanRenderGraph::cull() {
+    schedule.clear();
+
+    // Walk backwards from the outputs, a pass lives if it produces something a later living pass needs
+    std::vector<bool> needed(resources.size(), false);
+    std::vector<bool> alive(passes.size(), false);
+
+    for (size_t r = 0; r < resources.size(); r++) {
+        needed[r] = resources[r].output;
+    }
+
+    for (size_t p = passes.size(); p-- > 0;) {
+        const Pass &pass = passes[p];
+
+        bool is_alive = pass.side_effects || pass.writes_target;
+
+        for (const auto &attachment : pass.color_writes) {
+            is_alive |= needed[attachment.resource];
+        }
+
+        if (pass.depth_write.resource != INVALID_HANDLE) {
+            is_alive |= needed[pass.depth_write.resource];
+        }
+
+        if (!is_alive) {
+            continue;
+        }
+
+        alive[p] = true;
+
+        // A clear means whatever an earlier pass wrote is never seen, so that pass isn't needed for it
+        // Loading keeps the resource needed, and with it the earlier writer
+        for (const auto &attachment : pass.color_writes) {
+            if (attachment.clear && !resources[attachment.resource].output) {
+                needed[attachment.resource] = false;
+            }
+        }
+
+        if (pass.depth_write.resource != INVALID_HANDLE && pass.depth_write.clear && !resources[pass.depth_write.resource].output) {
+            needed[pass.depth_write.resource] = false;
+        }
+
+        for (auto read : pass.reads) {
+            needed[read] = true;
+        }
+    }
+
+    // Declaration order is already a valid order, a pass can only depend on passes declared before it
+    for (size_t p = 0; p < passes.size(); p++) {
+        if (alive[p]) {
+            schedule.push_back(static_cast<PassHandle>(p));
+        }
+    }
+
+    for (size_t s = 0; s + 1 < schedule.size(); s++) {
+        if (passes[schedule[s]].writes_target) {
+            throw std::runtime_error("Pass '" + passes[schedule[s]].name + "' writes the target, so it must be the last pass!");
+        }
+    }
+}
+
+void VulkanRenderGraph::analyze(std::vector<std::vector<Use>> &uses) {
+    uses.clear();
+    uses.resize(resources.size());
+
+    for (auto &resource : resources) {
+        resource.lifetime = Lifetime();
+    }
+
+    for (uint32_t s = 0; s < schedule.size(); s++) {
+        const Pass &pass = passes[schedule[s]];
+
+        for (auto read : pass.reads) {
+            if (uses[read].empty()) {
+                LOG("Warning: Pass '" << pass.name << "' reads '" << resources[read].name << "' before anything writes it, the contents are undefined!");
+            }
+
+            uses[read].push_back({s, UseType::Sampled});
+        }
+
+        for (const auto &attachment : pass.color_writes) {
+            uses[attachment.resource].push_back({s, UseType::ColorWrite});
+        }
+
+        if (pass.depth_write.resource != INVALID_HANDLE) {
+            uses[pass.depth_write.resource].push_back({s, UseType::DepthWrite});
+        }
+    }
+
+    for (size_t r = 0; r < resources.size(); r++) {
+        if (!uses[r].empty()) {
+            resources[r].lifetime.first_use = uses[r].front().schedule_index;
+            resources[r].lifetime.last_use = uses[r].back().schedule_index;
+        }
+    }
+}
+
+static VkExtent2D scale_extent(VkExtent2D vk_extent, float scale) {
+    VkExtent2D scaled;
+    {
+        scaled.width = std::max(1u, static_cast<uint32_t>(std::lround(vk_extent.width * scale)));
+        scaled.height = std::max(1u, static_cast<uint32_t>(std::lround(vk_extent.height * scale)));
+    }
+
+    return scaled;
+}
+
+void VulkanRenderGraph::build_images(VulkanInstance *vulkan_instance, const std::vector<std::vector<Use>> &uses) {
+    compiled->vulkan_images.resize(resources.size());
+    compiled->alias_groups.resize(resources.size(), INVALID_HANDLE);
+
+    std::vector<VulkanImage::ImageSettings> image_settings(resources.size());
+    std::vector<ResourceHandle> aliasable;
+
+    for (size_t r = 0; r < resources.size(); r++) {
+        const Resource &resource = resources[r];
+
+        if (resource.imported || uses[r].empty()) {
+            continue;
+        }
+
+        bool sampled = false;
+        for (const auto &use : uses[r]) {
+            sampled |= use.type == UseType::Sampled;
+        }
+
+        VkExtent2D vk_extent = scale_extent(compiled->vk_extent, resource.desc.scale);
+
+        VulkanImage::ImageSettings &settings = image_settings[r];
+        {
+            settings.vk_format = resource.desc.vk_format;
+            settings.vk_extent = {vk_extent.width, vk_extent.height, 1};
+            settings.vk_samples = resource.desc.vk_samples;
+
+            if (resource.desc.depth) {
+                settings.vk_usage_flags = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+                settings.vk_aspect_flags = VK_IMAGE_ASPECT_DEPTH_BIT;
+            } else {
+                settings.vk_usage_flags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+                settings.vk_aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+            }
+
+            if (sampled) {
+                settings.vk_usage_flags |= VK_IMAGE_USAGE_SAMPLED_BIT;
+            }
+
+            settings.generate_mipmaps = false;
+
+            // Written by a single pass and never stored, so it only ever exists inside that pass
+            settings.transient = !sampled && !resource.output && uses[r].size() == 1;
+        }
+
+        // Outputs are read after the graph is done, and a read before any write expects last frame's contents
+        if (!settings.transient && !resource.output && uses[r].front().type != UseType::Sampled) {
+            aliasable.push_back(static_cast<ResourceHandle>(r));
+        }
+    }
+
+    //
+    // Aliasing
+    //
+
+    // Biggest first, so the smaller images fill in the gaps behind them
+    struct AliasGroup {
+        VkMemoryRequirements vk_requirements;
+        std::vector<ResourceHandle> members;
+    };
+
+    std::vector<VkMemoryRequirements> vk_requirements(resources.size());
+    for (auto r : aliasable) {
+        vk_requirements[r] = VulkanImage::get_memory_requirements(vulkan_instance, image_settings[r]);
+    }
+
+    std::sort(aliasable.begin(), aliasable.end(), [&vk_requirements](ResourceHandle a, ResourceHandle b) {
+        return vk_requirements[a].size > vk_requirements[b].size;
+    });
+
+    std::vector<AliasGroup> groups;
+    std::vector<uint32_t> group_of(resources.size(), INVALID_HANDLE);
+
+    for (auto r : aliasable) {
+        const Lifetime &lifetime = resources[r].lifetime;
+
+        for (uint32_t g = 0; g < groups.size(); g++) {
+            AliasGroup &group = groups[g];
+
+            if ((group.vk_requirements.memoryTypeBits & vk_requirements[r].memoryTypeBits) == 0) {
+                continue;
+            }
+
+            bool overlaps = false;
+            for (auto member : group.members) {
+                const Lifetime &other = resources[member].lifetime;
+                overlaps |= lifetime.first_use <= other.last_use && other.first_use <= lifetime.last_use;
+            }
+
+            if (overlaps) {
+                continue;
+            }
+
+            group.vk_requirements.size = std::max(group.vk_requirements.size, vk_requirements[r].size);
+            group.vk_requirements.alignment = std::max(group.vk_requirements.alignment, vk_requirements[r].alignment);
+            group.vk_requirements.memoryTypeBits &= vk_requirements[r].memoryTypeBits;
+            group.members.push_back(r);
+
+            group_of[r] = g;
+            break;
+        }
+
+        if (group_of[r] == INVALID_HANDLE) {
+            group_of[r] = static_cast<uint32_t>(groups.size());
+            groups.push_back({vk_requirements[r], {r}});
+        }
+    }
+
+    VkDeviceSize saved = 0;
+
+    for (const auto &group : groups) {
+        // Nothing to share with, a regular allocation is just as good
+        if (group.members.size() < 2) {
+            continue;
+        }
+
+        VmaAllocationCreateInfo vma_alloc_info {};
+        {
+            vma_alloc_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            vma_alloc_info.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        }
+
+        VmaAllocation vma_allocation = nullptr;
+        VkResult result = vmaAllocateMemory(vulkan_instance->get_vma_allocator(), &group.vk_requirements, &vma_alloc_info, &vma_allocation, nullptr);
+
+        if (result != VK_SUCCESS) {
+            LOG("vmaAllocateMemory failed with error code (" << string_VkResult(result) << ")");
+            throw std::runtime_error("vmaAllocateMemory failed! Please check the log above for more info!");
+        }
+
+        auto index = static_cast<uint32_t>(compiled->vma_alias_allocations.size());
+        compiled->vma_alias_allocations.push_back(vma_allocation);
+
+        for (auto member : group.members) {
+            compiled->alias_groups[member] = index;
+            image_settings[member].vma_alias_allocation = vma_allocation;
+
+            saved += vk_requirements[member].size;
+        }
+
+        saved -= group.vk_requirements.size;
+    }
+
+    if (saved > 0) {
+        LOG("Aliasing saved " << saved / (1024 * 1024) << " MiB across " << compiled->vma_alias_allocations.size() << " allocation(s)");
+    }
+
+    for (size_t r = 0; r < resources.size(); r++) {
+        if (resources[r].imported || uses[r].empty()) {
+            continue;
+        }
+
+        compiled->vulkan_images[r] = std::make_unique<VulkanImage>(vulkan_instance, image_settings[r]);
+    }
+}
+
+const VulkanRenderGraph::Use *VulkanRenderGraph::find_alias_prior(const std::vector<std::vector<Use>> &uses, ResourceHandle resource) const {
+    uint32_t group = compiled->alias_groups[resource];
+
+    if (group == INVALID_HANDLE) {
+        return nullptr;
+    }
+
+    uint32_t first_use = resources[resource].lifetime.first_use;
+
+    // The closest earlier occupant this frame, otherwise the last occupant of the previous frame
+    const Use *closest = nullptr;
+    const Use *latest = nullptr;
+
+    for (size_t r = 0; r < resources.size(); r++) {
+        if (r == resource || compiled->alias_groups[r] != group) {
+            continue;
+        }
+
+        const Use &last = uses[r].back();
+
+        if (last.schedule_index < first_use && (closest == nullptr || last.schedule_index > closest->schedule_index)) {
+            closest = &last;
+        }
+
+        if (latest == nullptr || last.schedule_index > latest->schedule_index) {
+            latest = &last;
+        }
+    }
+
+    return closest != nullptr ? closest : latest;
+}
+
+VkImageLayout VulkanRenderGraph::get_use_layout(UseType type) {
+    switch (type) {
+        default:
+        case UseType::ColorWrite:
+            return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        case UseType::DepthWrite:
+            return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        case UseType::Sampled:
+            return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+}
+
+VkPipelineStageFlags VulkanRenderGraph::get_use_stages(UseType type) {
+    switch (type) {
+        default:
+        case UseType::ColorWrite:
+            return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+        case UseType::DepthWrite:
+            return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+        case UseType::Sampled:
+            return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    }
+}
+
+VkAccessFlags VulkanRenderGraph::get_use_access(UseType type) {
+    switch (type) {
+        default:
+        case UseType::ColorWrite:
+            return VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        case UseType::DepthWrite:
+            return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        case UseType::Sampled:
+            return VK_ACCESS_SHADER_READ_BIT;
+    }
+}
+
+void VulkanRenderGraph::build_passes(VulkanInstance *vulkan_instance, const std::vector<std::vector<Use>> &uses) {
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+
+    compiled->vulkan_render_passes.resize(schedule.size());
+    compiled->vk_framebuffers.resize(schedule.size(), nullptr);
+    compiled->attachments.resize(schedule.size());
+    compiled->vk_clear_values.resize(schedule.size());
+    compiled->vk_pass_extents.resize(schedule.size());
+
+    for (uint32_t s = 0; s < schedule.size(); s++) {
+        const Pass &pass = passes[schedule[s]];
+
+        if (pass.writes_target) {
+            continue;
+        }
+
+        FixedVector<Attachment, VulkanRenderPass::MAX_ATTACHMENTS + 1> attachments;
+        {
+            for (const auto &attachment : pass.color_writes) {
+                attachments.push_back(attachment);
+            }
+
+            if (pass.depth_write.resource != INVALID_HANDLE) {
+                attachments.push_back(pass.depth_write);
+            }
+        }
+
+        if (attachments.empty()) {
+            throw std::runtime_error("Pass '" + pass.name + "' doesn't write anything! Graph passes need at least one attachment!");
+        }
+
+        if (attachments.size() > VulkanRenderPass::MAX_ATTACHMENTS) {
+            throw std::runtime_error("Pass '" + pass.name + "' writes too many attachments! A render pass supports up to VulkanRenderPass::MAX_ATTACHMENTS!");
+        }
+
+        VulkanRenderPassBuilder builder;
+        builder.set_dynamic(vulkan_instance->has_dynamic_rendering());
+
+        // Everything the pass has to wait on, and everything later passes will wait on
+        VulkanRenderPassBuilder::SubpassDependency dependency_in;
+        {
+            dependency_in.src_subpass = VK_SUBPASS_EXTERNAL;
+            dependency_in.dst_subpass = 0;
+            dependency_in.vk_dependency_flags = 0;
+        }
+
+        VulkanRenderPassBuilder::SubpassDependency dependency_out;
+        {
+            dependency_out.src_subpass = 0;
+            dependency_out.dst_subpass = VK_SUBPASS_EXTERNAL;
+            dependency_out.vk_dependency_flags = 0;
+        }
+
+        VkExtent2D vk_pass_extent = {UINT32_MAX, UINT32_MAX};
+
+        FixedVector<VkImageView, VulkanRenderPass::MAX_ATTACHMENTS> vk_views;
+        auto &bindings = compiled->attachments[s];
+        auto &vk_clear_values = compiled->vk_clear_values[s];
+
+        for (const auto &attachment : attachments) {
+            const Resource &resource = resources[attachment.resource];
+            const std::vector<Use> &resource_uses = uses[attachment.resource];
+
+            UseType type = resource.desc.depth ? UseType::DepthWrite : UseType::ColorWrite;
+
+            size_t index = 0;
+            while (resource_uses[index].schedule_index != s || resource_uses[index].type != type) {
+                index++;
+            }
+
+            const Use *prev = index > 0 ? &resource_uses[index - 1] : nullptr;
+            const Use *next = index + 1 < resource_uses.size() ? &resource_uses[index + 1] : nullptr;
+
+            // Earlier writers leave the image in the layout we need, samplers leave it shader readable
+            VkImageLayout vk_layout_initial = VK_IMAGE_LAYOUT_UNDEFINED;
+            if (prev != nullptr) {
+                vk_layout_initial = prev->type == UseType::Sampled ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : get_use_layout(type);
+            }
+
+            VulkanRenderPassBuilder::AttachmentInfo info;
+            {
+                info.vk_format = resource.desc.vk_format;
+                info.vk_samples = resource.desc.vk_samples;
+
+                info.vk_layout_ref = get_use_layout(type);
+                info.vk_layout_initial = vk_layout_initial;
+
+                // The layout transition for the next use happens for free at the end of the pass
+                info.vk_layout_final = next != nullptr ? get_use_layout(next->type) : get_use_layout(type);
+
+                if (attachment.clear) {
+                    info.vk_load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                } else if (prev != nullptr) {
+                    info.vk_load_op = VK_ATTACHMENT_LOAD_OP_LOAD;
+                } else {
+                    info.vk_load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                }
+
+                info.vk_store_op = (next != nullptr || resource.output) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+                if (VulkanRenderPass::has_stencil(resource.desc.vk_format)) {
+                    info.vk_stencil_load_op = info.vk_load_op;
+                    info.vk_stencil_store_op = info.vk_store_op;
+                }
+            }
+
+            if (resource.desc.depth) {
+                builder.set_depth_attachment(info);
+            } else {
+                builder.push_color_attachment(info);
+            }
+
+            // Nothing earlier this frame means the hazard is with the last use from the previous frame
+            const Use &prior = prev != nullptr ? *prev : resource_uses.back();
+
+            dependency_in.vk_stage_flags_src |= get_use_stages(prior.type);
+            dependency_in.vk_stage_flags_dst |= get_use_stages(type);
+            dependency_in.vk_access_flags_dst |= get_use_access(type);
+
+            // Reads only need an execution dependency, there's nothing of theirs to make available
+            if (prior.type != UseType::Sampled) {
+                dependency_in.vk_access_flags_src |= get_use_access(prior.type) & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+            }
+
+            // The aliasing barrier, the memory may still be in use by the image that had it before us
+            // Our initial layout is undefined since we start this frame fresh, so only the dependency is needed
+            const Use *alias_prior = prev == nullptr ? find_alias_prior(uses, attachment.resource) : nullptr;
+
+            if (alias_prior != nullptr) {
+                dependency_in.vk_stage_flags_src |= get_use_stages(alias_prior->type);
+
+                if (alias_prior->type != UseType::Sampled) {
+                    dependency_in.vk_access_flags_src |= get_use_access(alias_prior->type) & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+                }
+            }
+
+            if (next != nullptr) {
+                dependency_out.vk_stage_flags_src |= get_use_stages(type);
+                dependency_out.vk_access_flags_src |= get_use_access(type) & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+
+                dependency_out.vk_stage_flags_dst |= get_use_stages(next->type);
+                dependency_out.vk_access_flags_dst |= get_use_access(next->type);
+            }
+
+            VulkanImage *vulkan_image = compiled->vulkan_images[attachment.resource].get();
+            vk_views.push_back(vulkan_image->get_vk_view());
+            bindings.push_back({vulkan_image->get_vk_image(), vulkan_image->get_vk_view()});
+
+            vk_pass_extent.width = std::min(vk_pass_extent.width, vulkan_image->get_vk_extent().width);
+            vk_pass_extent.height = std::min(vk_pass_extent.height, vulkan_image->get_vk_extent().height);
+
+            vk_clear_values.push_back(attachment.vk_clear_value);
+        }
+
+        VulkanRenderPassBuilder::SubpassInfo subpass;
+        {
+            for (uint32_t c = 0; c < pass.color_writes.size(); c++) {
+                subpass.output_indices.push_back(c);
+            }
+
+            if (pass.depth_write.resource != INVALID_HANDLE) {
+                subpass.depth_index = static_cast<uint32_t>(pass.color_writes.size());
+            }
+        }
+
+        builder.push_subpass(subpass);
+        builder.push_dependency(dependency_in);
+
+        if (dependency_out.vk_stage_flags_dst != 0) {
+            builder.push_dependency(dependency_out);
+        }
+
+        // Recompiling for a new extent produces the same passes, so resizes are cache hits
+        auto vulkan_render_pass = builder.build(vk_device, vulkan_instance->get_render_pass_cache());
+        compiled->vulkan_render_passes[s] = vulkan_render_pass;
+        compiled->vk_pass_extents[s] = vk_pass_extent;
+
+        // Dynamic passes bind the views directly, there's nothing to cache
+        if (vulkan_render_pass->is_dynamic()) {
+            continue;
+        }
+
+        VulkanFramebufferCache::FramebufferKey key;
+        {
+            key.vulkan_render_pass = vulkan_render_pass.get();
+            key.vk_extent = vk_pass_extent;
+            key.vk_views = vk_views;
+        }
+
+        compiled->vk_framebuffers[s] = vulkan_instance->get_framebuffer_cache()->get(vk_device, key);
+    }
+}
+
+bool VulkanRenderGraph::needs_compile(VkExtent2D vk_target_extent) const {
+    if (dirty || compiled == nullptr) {
+        return true;
+    }
+
+    return compiled->vk_extent.width != vk_target_extent.width || compiled->vk_extent.height != vk_target_extent.height;
+}
+
+std::unique_ptr<VulkanRenderGraph::Compiled> VulkanRenderGraph::compile(VulkanInstance *vulkan_instance, VkExtent2D vk_target_extent) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (!needs_compile(vk_target_extent)) {
+        return nullptr;
+    }
+
+    cull();
+
+    std::vector<std::vector<Use>> uses;
+    analyze(uses);
+
+    std::unique_ptr<Compiled> previous = std::move(compiled);
+
+    compiled = std::make_unique<Compiled>();
+    compiled->vk_extent = vk_target_extent;
+
+    build_images(vulkan_instance, uses);
+    build_passes(vulkan_instance, uses);
+
+    dirty = false;
+    return previous;
+}
+
+void VulkanRenderGraph::release_compiled(VulkanInstance *vulkan_instance, Compiled &target) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+
+    // The cache owns the framebuffers, dropping our views takes them with it
+    {
+        std::vector<VkImageView> vk_views;
+
+        for (auto &vulkan_image : target.vulkan_images) {
+            if (vulkan_image != nullptr) {
+                vk_views.push_back(vulkan_image->get_vk_view());
+            }
+        }
+
+        vulkan_instance->get_framebuffer_cache()->evict_views(vk_device, vk_views.data(), vk_views.size());
+        target.vk_framebuffers.clear();
+    }
+
+    for (auto &vulkan_render_pass : target.vulkan_render_passes) {
+        if (vulkan_render_pass != nullptr) {
+            vulkan_instance->get_framebuffer_cache()->evict_pass(vk_device, vulkan_render_pass.get());
+            vulkan_render_pass->release(vk_device);
+            vulkan_render_pass = nullptr;
+        }
+    }
+
+    for (auto &vulkan_image : target.vulkan_images) {
+        if (vulkan_image != nullptr) {
+            vulkan_image->release(vulkan_instance);
+            vulkan_image = nullptr;
+        }
+    }
+
+    // Only once every image placed in them is gone
+    for (auto &vma_allocation : target.vma_alias_allocations) {
+        vmaFreeMemory(vulkan_instance->get_vma_allocator(), vma_allocation);
+    }
+
+    target.vma_alias_allocations.clear();
+}
+
+void VulkanRenderGraph::release(VulkanInstance *vulkan_instance) {
+    if (compiled != nullptr) {
+        release_compiled(vulkan_instance, *compiled);
+        compiled = nullptr;
+    }
+
+    dirty = true;
+}
+
+//
+// Execution
+//
+void VulkanRenderGraph::begin_pass(VulkanInstance *vulkan_instance, VulkanCmdBuffer *vulkan_cmd_buffer, uint32_t schedule_index) {
+    if (compiled == nullptr) {
+        throw std::runtime_error("Graph wasn't compiled!");
+    }
+
+    auto &vulkan_render_pass = compiled->vulkan_render_passes.at(schedule_index);
+
+    if (vulkan_render_pass == nullptr) {
+        throw std::runtime_error("The target pass records the target's own render pass!");
+    }
+
+    VulkanRenderPass::StateInfo info {};
+    {
+        info.vulkan_cmd_buffer = vulkan_cmd_buffer;
+        info.vk_framebuffer = compiled->vk_framebuffers[schedule_index];
+        info.attachments = compiled->attachments[schedule_index];
+        info.vk_render_area = compiled->vk_pass_extents[schedule_index];
+        info.vk_clear_values = compiled->vk_clear_values[schedule_index];
+    }
+
+    vulkan_render_pass->begin(vulkan_instance, info);
+}
+
+void VulkanRenderGraph::end_pass(VulkanInstance *vulkan_instance, VulkanCmdBuffer *vulkan_cmd_buffer, uint32_t schedule_index) {
+    if (compiled == nullptr) {
+        throw std::runtime_error("Graph wasn't compiled!");
+    }
+
+    VulkanRenderPass::StateInfo info {};
+    {
+        info.vulkan_cmd_buffer = vulkan_cmd_buffer;
+        info.attachments = compiled->attachments[schedule_index];
+    }
+
+    compiled->vulkan_render_passes.at(schedule_index)->end(vulkan_instance, info);
+}
+
+//
+// Getters
+//
+VulkanRenderGraph::ResourceHandle VulkanRenderGraph::find_resource(const std::string &name) const {
+    for (size_t r = 0; r < resources.size(); r++) {
+        if (resources[r].name == name) {
+            return static_cast<ResourceHandle>(r);
+        }
+    }
+
+    return INVALID_HANDLE;
+}
+
+VulkanImage *VulkanRenderGraph::get_vulkan_image(ResourceHandle resource) const {
+    if (compiled == nullptr || resource >= compiled->vulkan_images.size()) {
+        return nullptr;
+    }
+
+    return compiled->vulkan_images[resource].get();
+}
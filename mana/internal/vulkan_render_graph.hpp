@@ -0,0 +1,259 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_RENDER_GRAPH_HPP
+#define MANA_VULKAN_RENDER_GRAPH_HPP
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <mana/internal/fixed_vector.hpp>
+#include <mana/internal/vulkan_render_pass.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanInstance;
+    class VulkanImage;
+    class VulkanCmdBuffer;
+
+    // Passes declare what they read and write, the graph works out everything else
+    //
+    // compile() culls passes nothing depends on, then walks the rest in declaration order
+    // From each resource's uses it picks load / store ops, layouts and the subpass dependencies between passes
+    // Every graph pass becomes its own VkRenderPass + VkFramebuffer, with no hand written barriers anywhere
+    //
+    // The target (the window) is imported rather than owned, the pass writing it records its own render pass
+    // Graph images are shared by every frame in flight, that's safe since they all run on the graphics queue
+    // and every pass's dependencies also cover the uses from the previous frame
+    //
+    // Images whose lifetimes don't overlap share memory, a later image starts where an earlier one is done
+    // The first pass to use an aliased image also waits on the last use of whatever was there before it
+    class VulkanRenderGraph {
+    public:
+        using ResourceHandle = uint32_t;
+        using PassHandle = uint32_t;
+
+        static constexpr uint32_t INVALID_HANDLE = UINT32_MAX;
+        static constexpr size_t MAX_READS = 8;
+
+        struct ImageDesc {
+            VkFormat vk_format = VK_FORMAT_UNDEFINED;
+            VkSampleCountFlagBits vk_samples = VK_SAMPLE_COUNT_1_BIT;
+
+            // Relative to the target extent, so graph images follow window resizes
+            float scale = 1.0f;
+
+            bool depth = false;
+        };
+
+        // Where a resource is in the frame, filled in by compile()
+        struct Lifetime {
+            // Indices into the schedule, INVALID_HANDLE if the resource is never used
+            uint32_t first_use = INVALID_HANDLE;
+            uint32_t last_use = INVALID_HANDLE;
+        };
+
+    protected:
+        enum class UseType {
+            ColorWrite,
+            DepthWrite,
+            Sampled
+        };
+
+        struct Resource {
+            std::string name;
+            ImageDesc desc;
+
+            bool imported = false;
+            bool output = false;
+
+            Lifetime lifetime;
+        };
+
+        struct Attachment {
+            ResourceHandle resource = INVALID_HANDLE;
+
+            bool clear = false;
+            VkClearValue vk_clear_value {};
+        };
+
+        struct Pass {
+            std::string name;
+
+            FixedVector<Attachment, VulkanRenderPass::MAX_ATTACHMENTS> color_writes;
+            Attachment depth_write;
+
+            FixedVector<ResourceHandle, MAX_READS> reads;
+
+            // Never culled, e.g. readbacks
+            bool side_effects = false;
+
+            // Writes the imported target, the caller records the target's own pass
+            bool writes_target = false;
+        };
+
+        // A use of a resource at a point in the schedule
+        struct Use {
+            uint32_t schedule_index;
+            UseType type;
+        };
+
+    public:
+        // Everything compile() creates, kept separate so a stale graph can be released once the GPU is done with it
+        struct Compiled {
+            VkExtent2D vk_extent {};
+
+            // Indexed by resource, null for imported and culled resources
+            std::vector<std::unique_ptr<VulkanImage>> vulkan_images;
+
+            // Indexed by resource, which of the alias allocations the image lives in (INVALID_HANDLE if none)
+            std::vector<uint32_t> alias_groups;
+            std::vector<VmaAllocation> vma_alias_allocations;
+
+            // Indexed by schedule position, null for the target pass
+            std::vector<std::shared_ptr<VulkanRenderPass>> vulkan_render_passes;
+            std::vector<VkFramebuffer> vk_framebuffers;
+
+            // Indexed by schedule position, the images dynamic passes bind when they begin
+            std::vector<FixedVector<VulkanRenderPass::AttachmentBinding, VulkanRenderPass::MAX_ATTACHMENTS>> attachments;
+            std::vector<VkExtent2D> vk_pass_extents;
+            std::vector<FixedVector<VkClearValue, VulkanRenderPass::MAX_ATTACHMENTS>> vk_clear_values;
+
+            ~Compiled();
+        };
+
+    protected:
+        std::vector<Resource> resources;
+        std::vector<Pass> passes;
+
+        // Alive passes in execution order
+        std::vector<PassHandle> schedule;
+
+        std::unique_ptr<Compiled> compiled;
+        bool dirty = true;
+
+        void cull();
+        void analyze(std::vector<std::vector<Use>> &uses);
+
+        void build_images(VulkanInstance *vulkan_instance, const std::vector<std::vector<Use>> &uses);
+        void build_passes(VulkanInstance *vulkan_instance, const std::vector<std::vector<Use>> &uses);
+
+        // The use the memory behind an aliased resource last saw before the resource's first use
+        const Use *find_alias_prior(const std::vector<std::vector<Use>> &uses, ResourceHandle resource) const;
+
+        static VkImageLayout get_use_layout(UseType type);
+        static VkPipelineStageFlags get_use_stages(UseType type);
+        static VkAccessFlags get_use_access(UseType type);
+
+    public:
+        //
+        // Declaration
+        // Any change marks the graph dirty, it's recompiled on the next compile()
+        //
+        ResourceHandle create_image(const std::string &name, const ImageDesc &desc);
+        ResourceHandle import_target(const std::string &name);
+
+        // Outputs are kept alive even when no pass reads them
+        void mark_output(ResourceHandle resource);
+
+        PassHandle add_pass(const std::string &name);
+
+        void write_color(PassHandle pass, ResourceHandle resource, const VkClearColorValue *clear = nullptr);
+        void write_depth(PassHandle pass, ResourceHandle resource, const VkClearDepthStencilValue *clear = nullptr);
+        void read(PassHandle pass, ResourceHandle resource);
+
+        void set_side_effects(PassHandle pass);
+
+        // Removes every pass and resource, the compiled graph is left for the caller to take and release
+        void clear();
+
+        //
+        // Compilation
+        //
+
+        // Does nothing if the graph is unchanged and the extent still matches
+        // The previous compiled graph is returned so the caller can release it once the GPU is done with it
+        [[nodiscard]]
+        std::unique_ptr<Compiled> compile(VulkanInstance *vulkan_instance, VkExtent2D vk_target_extent);
+
+        [[nodiscard]]
+        bool needs_compile(VkExtent2D vk_target_extent) const;
+
+        static void release_compiled(VulkanInstance *vulkan_instance, Compiled &target);
+        void release(VulkanInstance *vulkan_instance);
+
+        //
+        // Execution
+        // Walk get_schedule(), passes that don't write the target are wrapped in begin_pass() / end_pass()
+        //
+        void begin_pass(VulkanInstance *vulkan_instance, VulkanCmdBuffer *vulkan_cmd_buffer, uint32_t schedule_index);
+        void end_pass(VulkanInstance *vulkan_instance, VulkanCmdBuffer *vulkan_cmd_buffer, uint32_t schedule_index);
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        const std::vector<PassHandle> &get_schedule() const {
+            return schedule;
+        }
+
+        [[nodiscard]]
+        bool is_target_pass(PassHandle pass) const {
+            return passes[pass].writes_target;
+        }
+
+        // Null for the target pass, or before the graph was compiled
+        [[nodiscard]]
+        VulkanRenderPass *get_vulkan_render_pass(uint32_t schedule_index) const {
+            if (compiled == nullptr) {
+                return nullptr;
+            }
+
+            return compiled->vulkan_render_passes[schedule_index].get();
+        }
+
+        [[nodiscard]]
+        const std::string &get_pass_name(PassHandle pass) const {
+            return passes[pass].name;
+        }
+
+        [[nodiscard]]
+        ResourceHandle find_resource(const std::string &name) const;
+
+        [[nodiscard]]
+        const Lifetime &get_lifetime(ResourceHandle resource) const {
+            return resources[resource].lifetime;
+        }
+
+        // Null until compiled, or if the resource is imported or was culled
+        [[nodiscard]]
+        VulkanImage *get_vulkan_image(ResourceHandle resource) const;
+    };
+}
+
+#endif//MANA_VULKAN_RENDER_GRAPH_HPP
@@ -26,28 +26,62 @@ SOFTWARE.
 
 #include <mana/internal/vulkan_cmd_buffer.hpp>
 #include <mana/internal/vulkan_render_target.hpp>
+#include <mana/internal/vulkan_instance.hpp>
 
 #include <stdexcept>
 
 using namespace ManaVK::Internal;
 
+bool VulkanRenderPass::has_stencil(VkFormat vk_format) {
+    switch (vk_format) {
+        default:
+            return false;
+
+        case VK_FORMAT_S8_UINT:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return true;
+    }
+}
+
 VulkanRenderPass::VulkanRenderPass(const VulkanRenderPass::PassConfig &config) {
     this->vk_render_pass = config.vk_render_pass;
+    this->dynamic = config.dynamic;
+    this->attachments = config.attachments;
+    this->subpasses = config.subpasses;
+    this->dependency_in = config.dependency_in;
+    this->dependency_out = config.dependency_out;
     this->attachment_count = config.attachment_count;
     this->depth_index = config.depth_index;
+    this->transient_mask = config.transient_mask;
+    this->compatibility_id = config.compatibility_id;
 }
 
 // TODO: RenderPass begin without render target?
 void VulkanRenderPass::begin(VulkanInstance *vulkan_instance, const StateInfo &info) {
 
-    if (info.vulkan_render_target == nullptr) {
+    if (info.vulkan_render_target == nullptr && info.vk_framebuffer == nullptr && info.attachments.empty()) {
         throw std::runtime_error("vulkan_render_target was nullptr!");
     }
 
+    if (info.vulkan_render_target == nullptr && !info.vk_render_area) {
+        throw std::runtime_error("vk_render_area must be set when there's no render target!");
+    }
+
+    if (info.vulkan_cmd_buffer == nullptr) {
+        throw std::runtime_error("vulkan_cmd_buffer was nullptr!");
+    }
+
     if (vulkan_instance == nullptr) {
         throw std::runtime_error("vulkan_instance was nullptr!");
     }
 
+    if (dynamic) {
+        begin_dynamic(vulkan_instance, info);
+        return;
+    }
+
     if (vk_render_pass == nullptr) {
         throw std::runtime_error("vk_render_pass was nullptr!");
     }
@@ -55,14 +89,39 @@ void VulkanRenderPass::begin(VulkanInstance *vulkan_instance, const StateInfo &i
     //
     // Begin the render pass
     //
-    auto vk_cmd_buffer = info.vulkan_render_target->get_vulkan_cmd_buffer()->get_vk_cmd_buffer();
+    auto vk_cmd_buffer = info.vulkan_cmd_buffer->get_vk_cmd_buffer();
+
+    // Imageless framebuffers are handed this frame's views here instead of at creation
+    FixedVector<VkImageView, MAX_ATTACHMENTS> vk_imageless_views;
+
+    if (info.vk_framebuffer == nullptr && info.vulkan_render_target->is_imageless()) {
+        for (const auto &binding : info.vulkan_render_target->get_attachments()) {
+            vk_imageless_views.push_back(binding.vk_view);
+        }
+    }
+
+    VkRenderPassAttachmentBeginInfo attachment_begin_info {};
+    {
+        attachment_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO;
+
+        attachment_begin_info.attachmentCount = static_cast<uint32_t>(vk_imageless_views.size());
+        attachment_begin_info.pAttachments = vk_imageless_views.data();
+    }
 
     VkRenderPassBeginInfo begin_info {};
     {
         begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 
+        if (!vk_imageless_views.empty()) {
+            begin_info.pNext = &attachment_begin_info;
+        }
+
         begin_info.renderPass = vk_render_pass;
-        begin_info.framebuffer = info.vulkan_render_target->get_vk_framebuffer(vulkan_instance);
+        if (info.vk_framebuffer != nullptr) {
+            begin_info.framebuffer = info.vk_framebuffer;
+        } else {
+            begin_info.framebuffer = info.vulkan_render_target->get_vk_framebuffer(vulkan_instance);
+        }
 
         if (info.vk_render_offset) {
             begin_info.renderArea.offset = info.vk_render_offset.value();
@@ -80,24 +139,228 @@ void VulkanRenderPass::begin(VulkanInstance *vulkan_instance, const StateInfo &i
         begin_info.pClearValues = info.vk_clear_values.data();
     }
 
-    // TODO: Allow multiple command buffers for multiple subpasses?
-    vkCmdBeginRenderPass(vk_cmd_buffer, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(vk_cmd_buffer, &begin_info, info.vk_subpass_contents);
 }
 
-void VulkanRenderPass::end(const StateInfo &info) {
-    if (info.vulkan_render_target == nullptr) {
+void VulkanRenderPass::end(VulkanInstance *vulkan_instance, const StateInfo &info) {
+    if (info.vulkan_cmd_buffer == nullptr) {
         throw std::runtime_error("vulkan_cmd_buffer was nullptr!");
     }
 
-    vkCmdEndRenderPass(info.vulkan_render_target->get_vulkan_cmd_buffer()->get_vk_cmd_buffer());
+    if (!dynamic) {
+        vkCmdEndRenderPass(info.vulkan_cmd_buffer->get_vk_cmd_buffer());
+        return;
+    }
+
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    vulkan_instance->get_vk_cmd_end_rendering()(info.vulkan_cmd_buffer->get_vk_cmd_buffer());
+    record_barriers(info.vulkan_cmd_buffer->get_vk_cmd_buffer(), get_bindings(info), false);
+}
+
+//
+// Dynamic rendering
+//
+FixedVector<VulkanRenderPass::AttachmentBinding, VulkanRenderPass::MAX_ATTACHMENTS> VulkanRenderPass::get_bindings(const StateInfo &info) {
+    if (!info.attachments.empty()) {
+        return info.attachments;
+    }
+
+    if (info.vulkan_render_target == nullptr) {
+        throw std::runtime_error("Dynamic passes need attachments or a render target!");
+    }
+
+    return info.vulkan_render_target->get_attachments();
+}
+
+void VulkanRenderPass::record_barriers(VkCommandBuffer vk_cmd_buffer, const FixedVector<AttachmentBinding, MAX_ATTACHMENTS> &bindings, bool entering) const {
+    if (bindings.size() != attachments.size()) {
+        throw std::runtime_error("The number of bound attachments doesn't match the pass!");
+    }
+
+    // Same as a render pass, the implicit dependencies are top of pipe in and bottom of pipe out
+    const ExternalDependency &dependency = entering ? dependency_in : dependency_out;
+
+    VkPipelineStageFlags vk_stage_flags_src = dependency.vk_stage_flags_src;
+    VkPipelineStageFlags vk_stage_flags_dst = dependency.vk_stage_flags_dst;
+
+    FixedVector<VkImageMemoryBarrier, MAX_ATTACHMENTS> vk_barriers;
+
+    for (uint32_t a = 0; a < attachments.size(); a++) {
+        const AttachmentDesc &attachment = attachments[a];
+
+        bool depth = depth_index.has_value() && depth_index.value() == a;
+
+        VkPipelineStageFlags vk_attachment_stages = depth
+            ? VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+            : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+        VkAccessFlags vk_attachment_write = depth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        VkAccessFlags vk_attachment_read = depth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+
+        VkImageLayout vk_layout_old = entering ? attachment.vk_layout_initial : attachment.vk_layout_ref;
+        VkImageLayout vk_layout_new = entering ? attachment.vk_layout_ref : attachment.vk_layout_final;
+
+        // Render passes leave the layout alone when the final layout is undefined
+        if (vk_layout_new == VK_IMAGE_LAYOUT_UNDEFINED) {
+            vk_layout_new = vk_layout_old;
+        }
+
+        VkImageMemoryBarrier vk_barrier {};
+        {
+            vk_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+            vk_barrier.image = bindings[a].vk_image;
+            vk_barrier.oldLayout = vk_layout_old;
+            vk_barrier.newLayout = vk_layout_new;
+
+            vk_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            vk_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            vk_barrier.subresourceRange.aspectMask = depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+
+            if (has_stencil(attachment.vk_format)) {
+                vk_barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+            }
+
+            vk_barrier.subresourceRange.levelCount = 1;
+            vk_barrier.subresourceRange.layerCount = 1;
+
+            if (entering) {
+                vk_barrier.srcAccessMask = dependency.vk_access_flags_src;
+                vk_barrier.dstAccessMask = dependency.vk_access_flags_dst | vk_attachment_read | vk_attachment_write;
+            } else {
+                vk_barrier.srcAccessMask = dependency.vk_access_flags_src | vk_attachment_write;
+                vk_barrier.dstAccessMask = dependency.vk_access_flags_dst;
+            }
+        }
+
+        if (entering) {
+            vk_stage_flags_dst |= vk_attachment_stages;
+        } else {
+            vk_stage_flags_src |= vk_attachment_stages;
+        }
+
+        vk_barriers.push_back(vk_barrier);
+    }
+
+    if (vk_stage_flags_src == 0) {
+        vk_stage_flags_src = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+
+    if (vk_stage_flags_dst == 0) {
+        vk_stage_flags_dst = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    }
+
+    vkCmdPipelineBarrier(
+        vk_cmd_buffer,
+        vk_stage_flags_src,
+        vk_stage_flags_dst,
+        0,
+        0, nullptr,
+        0, nullptr,
+        static_cast<uint32_t>(vk_barriers.size()), vk_barriers.data()
+    );
+}
+
+void VulkanRenderPass::begin_dynamic(VulkanInstance *vulkan_instance, const StateInfo &info) {
+    if (!vulkan_instance->has_dynamic_rendering()) {
+        throw std::runtime_error("This pass uses dynamic rendering, but the device doesn't support it!");
+    }
+
+    auto vk_cmd_buffer = info.vulkan_cmd_buffer->get_vk_cmd_buffer();
+    FixedVector<AttachmentBinding, MAX_ATTACHMENTS> bindings = get_bindings(info);
+
+    record_barriers(vk_cmd_buffer, bindings, true);
+
+    FixedVector<VkRenderingAttachmentInfoKHR, MAX_ATTACHMENTS> vk_color_infos;
+    VkRenderingAttachmentInfoKHR vk_depth_info {};
+    VkRenderingAttachmentInfoKHR vk_stencil_info {};
+
+    for (uint32_t a = 0; a < attachments.size(); a++) {
+        const AttachmentDesc &attachment = attachments[a];
+
+        VkRenderingAttachmentInfoKHR vk_info {};
+        {
+            vk_info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+
+            vk_info.imageView = bindings[a].vk_view;
+            vk_info.imageLayout = attachment.vk_layout_ref;
+
+            vk_info.loadOp = attachment.vk_load_op;
+            vk_info.storeOp = attachment.vk_store_op;
+
+            if (a < info.vk_clear_values.size()) {
+                vk_info.clearValue = info.vk_clear_values[a];
+            }
+        }
+
+        if (depth_index.has_value() && depth_index.value() == a) {
+            vk_depth_info = vk_info;
+
+            if (has_stencil(attachment.vk_format)) {
+                vk_stencil_info = vk_info;
+                vk_stencil_info.loadOp = attachment.vk_stencil_load_op;
+                vk_stencil_info.storeOp = attachment.vk_stencil_store_op;
+            }
+        } else {
+            vk_color_infos.push_back(vk_info);
+        }
+    }
+
+    VkRenderingInfoKHR rendering_info {};
+    {
+        rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+
+        if (info.vk_subpass_contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS) {
+            rendering_info.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+        }
+
+        if (info.vk_render_offset) {
+            rendering_info.renderArea.offset = info.vk_render_offset.value();
+        }
+
+        if (info.vk_render_area) {
+            rendering_info.renderArea.extent = info.vk_render_area.value();
+        } else {
+            rendering_info.renderArea.extent = info.vulkan_render_target->get_vk_extent();
+        }
+
+        rendering_info.layerCount = 1;
+
+        rendering_info.colorAttachmentCount = static_cast<uint32_t>(vk_color_infos.size());
+        rendering_info.pColorAttachments = vk_color_infos.data();
+
+        if (depth_index.has_value()) {
+            rendering_info.pDepthAttachment = &vk_depth_info;
+
+            if (vk_stencil_info.sType == VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO) {
+                rendering_info.pStencilAttachment = &vk_stencil_info;
+            }
+        }
+    }
+
+    vulkan_instance->get_vk_cmd_begin_rendering()(vk_cmd_buffer, &rendering_info);
 }
 
 void VulkanRenderPass::release(VkDevice vk_device) {
+    if (cached) {
+        return;
+    }
+
     if (vk_render_pass != nullptr) {
         if (vk_device == nullptr) {
             throw std::runtime_error("vk_device was nullptr!");
         }
 
         vkDestroyRenderPass(vk_device, vk_render_pass, nullptr);
+        vk_render_pass = nullptr;
     }
 }
+
+void VulkanRenderPass::release_cached(VkDevice vk_device) {
+    cached = false;
+    release(vk_device);
+}
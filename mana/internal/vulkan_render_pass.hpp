@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include <vulkan/vulkan.h>
 
+#include <mana/internal/fixed_vector.hpp>
+
 #include <optional>
 #include <vector>
 
@@ -38,43 +40,188 @@ namespace ManaVK::Internal {
 
     class VulkanRenderPass {
     public:
+        static constexpr size_t MAX_ATTACHMENTS = 8;
+
+        // What a dynamic pass does with each attachment, the same things a VkAttachmentDescription says
+        struct AttachmentDesc {
+            VkFormat vk_format = VK_FORMAT_UNDEFINED;
+            VkSampleCountFlagBits vk_samples = VK_SAMPLE_COUNT_1_BIT;
+
+            VkAttachmentLoadOp vk_load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            VkAttachmentStoreOp vk_store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            VkAttachmentLoadOp vk_stencil_load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            VkAttachmentStoreOp vk_stencil_store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+            VkImageLayout vk_layout_initial = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkImageLayout vk_layout_ref = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkImageLayout vk_layout_final = VK_IMAGE_LAYOUT_UNDEFINED;
+        };
+
+        // What a subpass draws to, as indices into the pass's attachments
+        // Pipelines are built against a single subpass, so they need its outputs rather than the whole pass's
+        struct SubpassDesc {
+            FixedVector<uint32_t, MAX_ATTACHMENTS> color_indices;
+            std::optional<uint32_t> depth_index;
+        };
+
+        // The EXTERNAL subpass dependencies, dynamic passes record them as barriers
+        struct ExternalDependency {
+            VkPipelineStageFlags vk_stage_flags_src = 0;
+            VkAccessFlags vk_access_flags_src = 0;
+
+            VkPipelineStageFlags vk_stage_flags_dst = 0;
+            VkAccessFlags vk_access_flags_dst = 0;
+        };
+
+        // An image bound when the pass begins, for imageless framebuffers and dynamic rendering
+        struct AttachmentBinding {
+            VkImage vk_image = nullptr;
+            VkImageView vk_view = nullptr;
+        };
+
         struct PassConfig {
+            // Null for dynamic passes
             VkRenderPass vk_render_pass = nullptr;
 
+            // Begins with vkCmdBeginRenderingKHR, no VkRenderPass or VkFramebuffer exists
+            bool dynamic = false;
+
+            FixedVector<AttachmentDesc, MAX_ATTACHMENTS> attachments;
+            std::vector<SubpassDesc> subpasses;
+
+            ExternalDependency dependency_in;
+            ExternalDependency dependency_out;
+
             uint32_t attachment_count;
             std::optional<uint32_t> depth_index;
+
+            // Bit per attachment, set when the contents never leave the pass (see VulkanRenderPassBuilder)
+            uint32_t transient_mask = 0;
+
+            // Passes sharing an id are compatible, see VulkanRenderPassCache
+            // Only cached passes have one, UINT32_MAX otherwise
+            uint32_t compatibility_id = UINT32_MAX;
         };
 
         struct StateInfo {
             VulkanRenderTarget *vulkan_render_target = nullptr;
 
-            std::vector<VkClearValue> vk_clear_values;
+            // Overrides the target's framebuffer, the target may then be null but vk_render_area must be set
+            VkFramebuffer vk_framebuffer = nullptr;
+
+            // Overrides the target's attachments for dynamic passes, same rules as vk_framebuffer
+            FixedVector<AttachmentBinding, MAX_ATTACHMENTS> attachments;
+
+            // Where the pass is recorded, callers pick this since targets own more than one buffer
+            VulkanCmdBuffer *vulkan_cmd_buffer = nullptr;
+
+            // Secondary contents means the pass body comes from vkCmdExecuteCommands
+            VkSubpassContents vk_subpass_contents = VK_SUBPASS_CONTENTS_INLINE;
+
+            FixedVector<VkClearValue, MAX_ATTACHMENTS> vk_clear_values;
             std::optional<VkExtent2D> vk_render_area;
             std::optional<VkOffset2D> vk_render_offset;
         };
 
     protected:
         VkRenderPass vk_render_pass = nullptr;
+        bool dynamic = false;
+
+        FixedVector<AttachmentDesc, MAX_ATTACHMENTS> attachments;
+        std::vector<SubpassDesc> subpasses;
+        ExternalDependency dependency_in;
+        ExternalDependency dependency_out;
+
         uint32_t attachment_count = 0;
         std::optional<uint32_t> depth_index;
+        uint32_t transient_mask = 0;
+        uint32_t compatibility_id = UINT32_MAX;
+
+        // Either the override in the state info or the target's
+        static FixedVector<AttachmentBinding, MAX_ATTACHMENTS> get_bindings(const StateInfo &info);
+
+        // Stand in for the layout transitions and external dependencies a VkRenderPass would do
+        void record_barriers(VkCommandBuffer vk_cmd_buffer, const FixedVector<AttachmentBinding, MAX_ATTACHMENTS> &bindings, bool entering) const;
+
+        void begin_dynamic(VulkanInstance *vulkan_instance, const StateInfo &info);
+
+        // Owned by a VulkanRenderPassCache, only the cache may destroy it
+        bool cached = false;
 
     public:
         VulkanRenderPass(const PassConfig &config);
 
+        // Dynamic rendering binds the stencil aspect separately, so callers need to know if there is one
+        static bool has_stencil(VkFormat vk_format);
+
         void begin(VulkanInstance *vulkan_instance, const StateInfo &info);
-        void end(const StateInfo &info);
+        void end(VulkanInstance *vulkan_instance, const StateInfo &info);
 
+        // Does nothing for cached passes, other users may still hold them
         void release(VkDevice vk_device);
 
+        void mark_cached() {
+            cached = true;
+        }
+
+        // Called by the cache once nothing uses the pass anymore
+        void release_cached(VkDevice vk_device);
+
         [[nodiscard]]
         VkRenderPass get_vk_render_pass() const {
             return vk_render_pass;
         }
 
+        [[nodiscard]]
+        bool is_dynamic() const {
+            return dynamic;
+        }
+
+        [[nodiscard]]
+        uint32_t get_attachment_count() const {
+            return attachment_count;
+        }
+
+        [[nodiscard]]
+        const AttachmentDesc &get_attachment(uint32_t index) const {
+            return attachments[index];
+        }
+
+        [[nodiscard]]
+        uint32_t get_subpass_count() const {
+            return static_cast<uint32_t>(subpasses.size());
+        }
+
+        [[nodiscard]]
+        const SubpassDesc &get_subpass(uint32_t index) const {
+            return subpasses[index];
+        }
+
+        [[nodiscard]]
+        uint32_t get_compatibility_id() const {
+            return compatibility_id;
+        }
+
+        [[nodiscard]]
+        bool is_cached() const {
+            return cached;
+        }
+
         [[nodiscard]]
         bool has_depth() const {
             return depth_index.has_value();
         }
+
+        // Transient attachments can live in lazily allocated memory, they may never be backed at all on tilers
+        [[nodiscard]]
+        bool is_attachment_transient(uint32_t index) const {
+            return (transient_mask & (1u << index)) != 0;
+        }
+
+        [[nodiscard]]
+        bool is_depth_transient() const {
+            return depth_index.has_value() && is_attachment_transient(depth_index.value());
+        }
     };
 }
 
@@ -52,7 +52,11 @@ void Internal::VulkanRenderPassBuilder::set_depth_attachment(const AttachmentInf
     depth_attachment = decompose_attachment(info);
 }
 
-std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::build(VkDevice vk_device) {
+void Internal::VulkanRenderPassBuilder::set_dynamic(bool dynamic) {
+    this->dynamic = dynamic;
+}
+
+std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::build(VkDevice vk_device, VulkanRenderPassCache *cache) {
     if (vk_device == nullptr) {
         throw std::runtime_error("vk_device was nullptr!");
     }
@@ -61,6 +65,26 @@ std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::b
         throw std::runtime_error("subpasses was empty, this is not allowed!");
     }
 
+    // Subpasses and input attachments need VK_KHR_dynamic_rendering_local_read, which we don't use
+    if (dynamic && (subpasses.size() > 1 || !subpasses[0].input_indices.empty())) {
+        throw std::runtime_error("Dynamic render passes can only have a single subpass without input attachments!");
+    }
+
+    if (cache == nullptr) {
+        return create(vk_device, UINT32_MAX);
+    }
+
+    VulkanRenderPassCache::PassKey key = make_key(false);
+
+    if (auto vulkan_render_pass = cache->find(key)) {
+        return vulkan_render_pass;
+    }
+
+    uint32_t compatibility_id = cache->get_compatibility_id(make_key(true));
+    return cache->insert(vk_device, key, create(vk_device, compatibility_id));
+}
+
+std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::create(VkDevice vk_device, uint32_t compatibility_id) {
     //
     // Reference building
     //
@@ -73,6 +97,10 @@ std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::b
         }
     }
 
+    if (attachments.size() > VulkanRenderPass::MAX_ATTACHMENTS) {
+        throw std::runtime_error("Too many attachments! A render pass supports up to VulkanRenderPass::MAX_ATTACHMENTS!");
+    }
+
     std::vector<VkAttachmentDescription> vk_attachments;
     std::vector<VkAttachmentReference> vk_attachment_refs;
     {
@@ -92,51 +120,45 @@ std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::b
     //
     // Subpass building
     //
-    std::vector<std::unique_ptr<VkAttachmentReference[]>> jagged_inputs;
-    std::vector<std::unique_ptr<VkAttachmentReference[]>> jagged_outputs;
-    {
-        for (const auto& subpass : subpasses) {
-            auto inputs = std::make_unique<VkAttachmentReference[]>(subpass.input_indices.size());
-            auto outputs = std::make_unique<VkAttachmentReference[]>(subpass.output_indices.size());
-
-            uint32_t index = 0;
-
-            for (auto input : subpass.input_indices) {
-                inputs[index++] = vk_attachment_refs[input];
-            }
 
-            index = 0;
-
-            for (auto output : subpass.output_indices) {
-                outputs[index++] = vk_attachment_refs[output];
-            }
+    // Every subpass's references live in one flat array, sized up front so the pointers below stay valid
+    std::vector<VkAttachmentReference> vk_subpass_refs;
+    {
+        size_t count = 0;
 
-            jagged_inputs.emplace_back(std::move(inputs));
-            jagged_outputs.emplace_back(std::move(outputs));
+        for (const auto& subpass : subpasses) {
+            count += subpass.input_indices.size() + subpass.output_indices.size();
         }
+
+        vk_subpass_refs.reserve(count);
     }
 
     std::vector<VkSubpassDescription> vk_subpasses;
     {
-        uint32_t index = 0;
-
         for (const auto& subpass : subpasses) {
             VkSubpassDescription vk_subpass{};
             {
                 vk_subpass.pipelineBindPoint = subpass.vk_bind_point;
 
+                vk_subpass.inputAttachmentCount = subpass.input_indices.size();
+                vk_subpass.pInputAttachments = vk_subpass_refs.data() + vk_subpass_refs.size();
+
+                for (auto input : subpass.input_indices) {
+                    vk_subpass_refs.push_back(vk_attachment_refs[input]);
+                }
+
                 vk_subpass.colorAttachmentCount = subpass.output_indices.size();
-                vk_subpass.pColorAttachments = jagged_outputs[index].get();
+                vk_subpass.pColorAttachments = vk_subpass_refs.data() + vk_subpass_refs.size();
 
-                vk_subpass.inputAttachmentCount = subpass.input_indices.size();
-                vk_subpass.pInputAttachments = jagged_inputs[index].get();
+                for (auto output : subpass.output_indices) {
+                    vk_subpass_refs.push_back(vk_attachment_refs[output]);
+                }
 
                 if (subpass.depth_index.has_value()) {
                     vk_subpass.pDepthStencilAttachment = vk_attachment_refs.data() + subpass.depth_index.value();
                 }
             }
 
-            index++;
             vk_subpasses.emplace_back(vk_subpass);
         }
     }
@@ -165,6 +187,81 @@ std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::b
     //
     // Render pass creation
     //
+    VulkanRenderPass::PassConfig config {};
+    {
+        config.dynamic = dynamic;
+
+        for (const auto &attachment : attachments) {
+            const VkAttachmentDescription &vk_description = attachment.vk_description;
+
+            VulkanRenderPass::AttachmentDesc desc {};
+            {
+                desc.vk_format = vk_description.format;
+                desc.vk_samples = vk_description.samples;
+
+                desc.vk_load_op = vk_description.loadOp;
+                desc.vk_store_op = vk_description.storeOp;
+                desc.vk_stencil_load_op = vk_description.stencilLoadOp;
+                desc.vk_stencil_store_op = vk_description.stencilStoreOp;
+
+                desc.vk_layout_initial = vk_description.initialLayout;
+                desc.vk_layout_ref = attachment.vk_layout_ref;
+                desc.vk_layout_final = vk_description.finalLayout;
+            }
+
+            config.attachments.push_back(desc);
+        }
+
+        // Only the EXTERNAL edges matter to a single subpass, they become the barriers around a dynamic pass
+        for (const auto &dependency : dependencies) {
+            VulkanRenderPass::ExternalDependency *external = nullptr;
+
+            if (dependency.src_subpass == VK_SUBPASS_EXTERNAL) {
+                external = &config.dependency_in;
+            } else if (dependency.dst_subpass == VK_SUBPASS_EXTERNAL) {
+                external = &config.dependency_out;
+            }
+
+            if (external != nullptr) {
+                external->vk_stage_flags_src |= dependency.vk_stage_flags_src;
+                external->vk_access_flags_src |= dependency.vk_access_flags_src;
+                external->vk_stage_flags_dst |= dependency.vk_stage_flags_dst;
+                external->vk_access_flags_dst |= dependency.vk_access_flags_dst;
+            }
+        }
+
+        for (uint32_t a = 0; a < attachments.size(); a++) {
+            if (is_transient(attachments[a])) {
+                config.transient_mask |= 1u << a;
+            }
+        }
+
+        for (const auto &subpass : subpasses) {
+            VulkanRenderPass::SubpassDesc desc;
+            {
+                for (auto output : subpass.output_indices) {
+                    desc.color_indices.push_back(output);
+                }
+
+                desc.depth_index = subpass.depth_index;
+            }
+
+            config.subpasses.push_back(desc);
+        }
+
+        config.attachment_count = color_attachments.size();
+        config.compatibility_id = compatibility_id;
+
+        if (depth_attachment.has_value()) {
+            config.depth_index = color_attachments.size();
+            config.attachment_count += 1;
+        }
+    }
+
+    if (dynamic) {
+        return std::make_shared<VulkanRenderPass>(config);
+    }
+
     VkRenderPassCreateInfo render_pass_create_info{};
     {
         render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -187,17 +284,7 @@ std::shared_ptr<Internal::VulkanRenderPass> Internal::VulkanRenderPassBuilder::b
         throw std::runtime_error("vkCreateRenderPass failed! Please check the log above for more info!");
     }
 
-    VulkanRenderPass::PassConfig config {};
-    {
-        config.vk_render_pass = vk_render_pass;
-
-        config.attachment_count = color_attachments.size();
-
-        if (depth_attachment.has_value()) {
-            config.depth_index = color_attachments.size();
-            config.attachment_count += 1;
-        }
-    }
+    config.vk_render_pass = vk_render_pass;
 
     return std::make_shared<VulkanRenderPass>(config);
 }
@@ -228,3 +315,86 @@ Internal::VulkanRenderPassBuilder::Attachment Internal::VulkanRenderPassBuilder:
 
     return attachment;
 }
+
+Internal::VulkanRenderPassCache::PassKey Internal::VulkanRenderPassBuilder::make_key(bool compatibility) const {
+    VulkanRenderPassCache::PassKey key;
+    std::vector<uint32_t> &words = key.words;
+
+    // Dynamic passes are never compatible with real ones, pipelines are built differently for each
+    words.push_back(dynamic);
+
+    auto push_attachment = [&words, compatibility](const Attachment &attachment) {
+        const VkAttachmentDescription &vk_description = attachment.vk_description;
+
+        words.push_back(vk_description.format);
+        words.push_back(vk_description.samples);
+
+        if (!compatibility) {
+            words.push_back(vk_description.loadOp);
+            words.push_back(vk_description.storeOp);
+            words.push_back(vk_description.stencilLoadOp);
+            words.push_back(vk_description.stencilStoreOp);
+            words.push_back(vk_description.initialLayout);
+            words.push_back(vk_description.finalLayout);
+            words.push_back(attachment.vk_layout_ref);
+        }
+    };
+
+    words.push_back(static_cast<uint32_t>(color_attachments.size()));
+    for (const auto &attachment : color_attachments) {
+        push_attachment(attachment);
+    }
+
+    words.push_back(depth_attachment.has_value());
+    if (depth_attachment.has_value()) {
+        push_attachment(depth_attachment.value());
+    }
+
+    words.push_back(static_cast<uint32_t>(subpasses.size()));
+    for (const auto &subpass : subpasses) {
+        words.push_back(subpass.vk_bind_point);
+
+        words.push_back(static_cast<uint32_t>(subpass.input_indices.size()));
+        words.insert(words.end(), subpass.input_indices.begin(), subpass.input_indices.end());
+
+        words.push_back(static_cast<uint32_t>(subpass.output_indices.size()));
+        words.insert(words.end(), subpass.output_indices.begin(), subpass.output_indices.end());
+
+        words.push_back(subpass.depth_index.value_or(UINT32_MAX));
+    }
+
+    words.push_back(static_cast<uint32_t>(dependencies.size()));
+    for (const auto &dependency : dependencies) {
+        words.push_back(dependency.src_subpass);
+        words.push_back(dependency.dst_subpass);
+        words.push_back(dependency.vk_stage_flags_src);
+        words.push_back(dependency.vk_access_flags_src);
+        words.push_back(dependency.vk_stage_flags_dst);
+        words.push_back(dependency.vk_access_flags_dst);
+        words.push_back(dependency.vk_dependency_flags);
+    }
+
+    key.hash = VulkanRenderPassCache::hash_words(words);
+    return key;
+}
+
+bool Internal::VulkanRenderPassBuilder::is_transient(const Attachment &attachment) {
+    const VkAttachmentDescription &vk_description = attachment.vk_description;
+
+    // Initial contents would have to come from memory, clearing doesn't
+    if (vk_description.initialLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+        return false;
+    }
+
+    if (vk_description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD || vk_description.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD) {
+        return false;
+    }
+
+    if (vk_description.storeOp == VK_ATTACHMENT_STORE_OP_STORE || vk_description.stencilStoreOp == VK_ATTACHMENT_STORE_OP_STORE) {
+        return false;
+    }
+
+    // Presenting or sampling afterwards both need the contents to outlive the pass
+    return vk_description.finalLayout != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+        && vk_description.finalLayout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include <vulkan/vulkan.h>
 
+#include <mana/internal/vulkan_render_pass_cache.hpp>
+
 #include <vector>
 #include <optional>
 #include <memory>
@@ -88,6 +90,8 @@ namespace ManaVK::Internal {
         std::vector<SubpassInfo> subpasses;
         std::vector<SubpassDependency> dependencies;
 
+        bool dynamic = false;
+
     public:
         //
         // Methods
@@ -98,13 +102,26 @@ namespace ManaVK::Internal {
         void push_color_attachment(const AttachmentInfo &info);
         void set_depth_attachment(const AttachmentInfo &info);
 
-        std::shared_ptr<VulkanRenderPass> build(VkDevice vk_device);
+        // Builds a dynamic rendering pass instead, see VulkanRenderPass::is_dynamic()
+        // Only single subpass passes without input attachments can be dynamic
+        void set_dynamic(bool dynamic);
+
+        // With a cache, an identical description returns the pass built the first time instead of a new one
+        std::shared_ptr<VulkanRenderPass> build(VkDevice vk_device, VulkanRenderPassCache *cache = nullptr);
 
     protected:
         //
         // Helpers
         //
         static Attachment decompose_attachment(const AttachmentInfo& info);
+
+        // Compatibility keys leave out everything render pass compatibility ignores (ops and layouts)
+        VulkanRenderPassCache::PassKey make_key(bool compatibility) const;
+
+        std::shared_ptr<VulkanRenderPass> create(VkDevice vk_device, uint32_t compatibility_id);
+
+        // Nothing is loaded in or stored out, so the contents only ever exist during the pass
+        static bool is_transient(const Attachment& attachment);
     };
 }
 
@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_render_pass_cache.hpp"
+
+#include <mana/internal/vulkan_render_pass.hpp>
+
+#include <stdexcept>
+#include <iostream>
+
+using namespace ManaVK::Internal;
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanRenderPassCache]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+uint64_t VulkanRenderPassCache::hash_words(const std::vector<uint32_t> &words) {
+    uint64_t hash = 14695981039346656037ull;
+
+    for (auto word : words) {
+        for (int b = 0; b < 4; b++) {
+            hash ^= (word >> (b * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    }
+
+    return hash;
+}
+
+std::shared_ptr<VulkanRenderPass> VulkanRenderPassCache::find(const PassKey &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto iter = passes.find(key);
+
+    if (iter == passes.end()) {
+        misses++;
+        return nullptr;
+    }
+
+    hits++;
+    return iter->second;
+}
+
+std::shared_ptr<VulkanRenderPass> VulkanRenderPassCache::insert(VkDevice vk_device, const PassKey &key, std::shared_ptr<VulkanRenderPass> vulkan_render_pass) {
+    if (vulkan_render_pass == nullptr) {
+        throw std::runtime_error("vulkan_render_pass was nullptr!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto iter = passes.find(key);
+
+    // Lost a race with another thread building the same pass, keep theirs
+    if (iter != passes.end()) {
+        vulkan_render_pass->release(vk_device);
+        return iter->second;
+    }
+
+    vulkan_render_pass->mark_cached();
+    passes.emplace(key, vulkan_render_pass);
+
+    return vulkan_render_pass;
+}
+
+uint32_t VulkanRenderPassCache::get_compatibility_id(const PassKey &compatibility_key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto iter = compatibility_ids.find(compatibility_key);
+
+    if (iter != compatibility_ids.end()) {
+        return iter->second;
+    }
+
+    auto id = static_cast<uint32_t>(compatibility_ids.size());
+    compatibility_ids.emplace(compatibility_key, id);
+
+    return id;
+}
+
+void VulkanRenderPassCache::release(VkDevice vk_device) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    LOG("Releasing " << passes.size() << " render pass(es), " << hits << " hit(s) and " << misses << " miss(es)");
+
+    for (auto &pair : passes) {
+        pair.second->release_cached(vk_device);
+    }
+
+    passes.clear();
+    compatibility_ids.clear();
+}
@@ -0,0 +1,112 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_RENDER_PASS_CACHE_HPP
+#define MANA_VULKAN_RENDER_PASS_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanRenderPass;
+
+    // Device wide, so identical VulkanRenderPassBuilder descriptions share a single VkRenderPass
+    //
+    // Keys are the full description flattened into words, the hash only picks the bucket
+    // Passes that only differ in load / store ops and layouts are compatible (see the spec's render pass compatibility)
+    // They share a compatibility id, framebuffers and pipelines made for one can be used with the others
+    //
+    // Cached passes belong to the cache, VulkanRenderPass::release() leaves them alone
+    class VulkanRenderPassCache {
+    public:
+        struct PassKey {
+            std::vector<uint32_t> words;
+            uint64_t hash = 0;
+
+            bool operator==(const PassKey &other) const {
+                return hash == other.hash && words == other.words;
+            }
+        };
+
+        struct PassKeyHasher {
+            size_t operator()(const PassKey &key) const {
+                return static_cast<size_t>(key.hash);
+            }
+        };
+
+        // FNV-1a, stable across runs so ids can be logged and compared
+        static uint64_t hash_words(const std::vector<uint32_t> &words);
+
+    protected:
+        std::mutex mutex;
+
+        std::unordered_map<PassKey, std::shared_ptr<VulkanRenderPass>, PassKeyHasher> passes;
+
+        // Every distinct compatibility key seen so far, ids are handed out in order
+        std::unordered_map<PassKey, uint32_t, PassKeyHasher> compatibility_ids;
+
+        std::atomic<uint64_t> hits {0};
+        std::atomic<uint64_t> misses {0};
+
+    public:
+        // Thread safe, returns null on a miss
+        std::shared_ptr<VulkanRenderPass> find(const PassKey &key);
+
+        // Thread safe, if another thread inserted the same key first its pass wins and is returned instead
+        std::shared_ptr<VulkanRenderPass> insert(VkDevice vk_device, const PassKey &key, std::shared_ptr<VulkanRenderPass> vulkan_render_pass);
+
+        // Thread safe, equal keys always get the same id
+        uint32_t get_compatibility_id(const PassKey &compatibility_key);
+
+        void release(VkDevice vk_device);
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        uint64_t get_hits() const {
+            return hits;
+        }
+
+        [[nodiscard]]
+        uint64_t get_misses() const {
+            return misses;
+        }
+
+        [[nodiscard]]
+        size_t get_size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return passes.size();
+        }
+    };
+}
+
+#endif//MANA_VULKAN_RENDER_PASS_CACHE_HPP
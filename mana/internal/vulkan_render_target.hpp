@@ -27,17 +27,66 @@ SOFTWARE.
 
 #include <vulkan/vulkan.h>
 
+#include <mana/internal/fixed_vector.hpp>
+#include <mana/internal/vulkan_render_pass.hpp>
+#include <mana/internal/vulkan_scheduler.hpp>
+
 #include <memory>
 
 namespace ManaVK::Internal {
     class VulkanInstance;
     class VulkanCmdBuffer;
+    class VulkanCmdPool;
+    class VulkanFrameArena;
+    class VulkanTransientBuffer;
 
-    // TODO: Frames in flight
+    // Targets may have multiple frames in flight
+    // All per-frame getters return the objects belonging to the frame slot selected by the last await_frame()
     class VulkanRenderTarget {
+    public:
+        enum class AcquireResult {
+            Success,
+
+            // We got an image, but the target should be recreated soon
+            Suboptimal,
+
+            // No image was acquired, the target must be recreated first
+            OutOfDate,
+
+            // No image was ready in time, skip the frame instead of stalling
+            Timeout
+        };
+
     public:
         [[nodiscard]]
-        virtual std::shared_ptr<VulkanCmdBuffer> get_vulkan_cmd_buffer() const = 0;
+        virtual uint32_t get_frames_in_flight() const = 0;
+
+        // Records work that touches the target, submitted once the target has been acquired
+        [[nodiscard]]
+        virtual VulkanCmdBuffer *get_vulkan_cmd_buffer() const = 0;
+
+        // Records work that doesn't need the target, submitted before the target is acquired
+        [[nodiscard]]
+        virtual VulkanCmdBuffer *get_vulkan_cmd_buffer_offscreen() const = 0;
+
+        // Swaps in a fresh offscreen buffer, for recording more offscreen work after the previous one was submitted
+        // A submitted buffer is pending until the GPU is done with it, so it can't be begun again this frame
+        virtual VulkanCmdBuffer *next_vulkan_cmd_buffer_offscreen(VulkanInstance *vulkan_instance) = 0;
+
+        // Scratch memory that lives until this frame slot comes around again
+        [[nodiscard]]
+        virtual VulkanFrameArena *get_frame_arena() const = 0;
+
+        // GPU visible scratch memory that lives until this frame slot comes around again
+        [[nodiscard]]
+        virtual VulkanTransientBuffer *get_transient_buffer() const = 0;
+
+        // Secondary buffer pool for a recording thread, created on first use
+        // Each worker index must only ever be used by one thread at a time
+        virtual VulkanCmdPool *get_vulkan_worker_pool(VulkanInstance *vulkan_instance, uint32_t worker) = 0;
+
+        // Primary buffer pool on the compute queue, created on first use
+        virtual VulkanCmdPool *get_vulkan_compute_pool(VulkanInstance *vulkan_instance) = 0;
 
         [[nodiscard]]
         virtual VkExtent2D get_vk_extent() const = 0;
@@ -45,17 +94,28 @@ namespace ManaVK::Internal {
         [[nodiscard]]
         virtual VkFramebuffer get_vk_framebuffer(VulkanInstance *vulkan_instance) const = 0;
 
+        // True if get_vk_framebuffer() is imageless, get_attachments() are then bound when the pass begins
+        [[nodiscard]]
+        virtual bool is_imageless() const = 0;
+
+        // This frame's attachments in render pass order, for imageless framebuffers and dynamic passes
+        [[nodiscard]]
+        virtual FixedVector<VulkanRenderPass::AttachmentBinding, VulkanRenderPass::MAX_ATTACHMENTS> get_attachments() const = 0;
+
         [[nodiscard]]
         virtual VkSemaphore get_vk_semaphore_work_done() const = 0;
 
         [[nodiscard]]
         virtual VkSemaphore get_vk_semaphore_image_ready() const = 0;
 
-        [[nodiscard]]
-        virtual VkFence get_vk_fence() const = 0;
+        // Tells the target the current frame slot has work up to this point, one point is tracked per queue
+        virtual void set_frame_point(const VulkanScheduler::TimelinePoint &point) = 0;
+
+        virtual void await_frame(VulkanInstance *vulkan_instance) = 0;
 
-        virtual void await_frame(VulkanInstance *vulkan_instance) const = 0;
-        virtual void present_frame(VulkanInstance *vulkan_instance) const = 0;
+        // Must succeed (or be suboptimal) before the framebuffer can be used
+        virtual AcquireResult acquire_frame(VulkanInstance *vulkan_instance) = 0;
+        virtual void present_frame(VulkanInstance *vulkan_instance) = 0;
     };
 }
 
@@ -0,0 +1,205 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_scheduler.hpp"
+
+#include <mana/internal/vulkan_queue.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanScheduler]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+using namespace ManaVK::Internal;
+
+VulkanScheduler::VulkanScheduler(VkDevice vk_device, const std::vector<VulkanQueue*>& queues) {
+    if (vk_device == nullptr) {
+        throw std::runtime_error("vk_device was nullptr!");
+    }
+
+    this->vk_device = vk_device;
+
+    for (auto queue : queues) {
+        if (queue == nullptr) {
+            continue;
+        }
+
+        // The same queue might be passed in under multiple roles
+        if (std::find(vulkan_queues.begin(), vulkan_queues.end(), queue) != vulkan_queues.end()) {
+            continue;
+        }
+
+        queue->create_timeline(vk_device);
+        vulkan_queues.push_back(queue);
+    }
+}
+
+void VulkanScheduler::release() {
+    for (auto queue : vulkan_queues) {
+        queue->release_timeline(vk_device);
+    }
+
+    vulkan_queues.clear();
+}
+
+//
+// CPU synchronization
+//
+bool VulkanScheduler::wait(const TimelinePoint &point, uint64_t timeout) const {
+    // Nothing was ever submitted, so there's nothing to wait for
+    if (!point.is_valid()) {
+        return true;
+    }
+
+    // Called every frame, so this skips the arrays wait_all() has to build
+    point.vulkan_queue->flush_submits(point.value);
+
+    VkSemaphore vk_semaphore = point.vulkan_queue->get_vk_timeline();
+
+    VkSemaphoreWaitInfo wait_info {};
+    {
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &vk_semaphore;
+        wait_info.pValues = &point.value;
+    }
+
+    VkResult result = vkWaitSemaphores(vk_device, &wait_info, timeout);
+
+    if (result == VK_TIMEOUT) {
+        return false;
+    }
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkWaitSemaphores failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkWaitSemaphores failed! Please check the log above for more info!");
+    }
+
+    return true;
+}
+
+bool VulkanScheduler::wait_all(const std::vector<TimelinePoint> &points, uint64_t timeout) const {
+    std::vector<VkSemaphore> vk_semaphores;
+    std::vector<uint64_t> values;
+
+    for (const auto& point : points) {
+        if (!point.is_valid()) {
+            continue;
+        }
+
+        // Waiting on work that's still batched would never finish
+        point.vulkan_queue->flush_submits(point.value);
+
+        vk_semaphores.push_back(point.vulkan_queue->get_vk_timeline());
+        values.push_back(point.value);
+    }
+
+    if (vk_semaphores.empty()) {
+        return true;
+    }
+
+    VkSemaphoreWaitInfo wait_info {};
+    {
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+
+        wait_info.semaphoreCount = static_cast<uint32_t>(vk_semaphores.size());
+        wait_info.pSemaphores = vk_semaphores.data();
+        wait_info.pValues = values.data();
+    }
+
+    VkResult result = vkWaitSemaphores(vk_device, &wait_info, timeout);
+
+    if (result == VK_TIMEOUT) {
+        return false;
+    }
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkWaitSemaphores failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkWaitSemaphores failed! Please check the log above for more info!");
+    }
+
+    return true;
+}
+
+bool VulkanScheduler::is_complete(const TimelinePoint &point) const {
+    if (!point.is_valid()) {
+        return true;
+    }
+
+    // Polling is usually followed by waiting, so make sure the work is actually on its way
+    point.vulkan_queue->flush_submits(point.value);
+    return get_completed_value(point.vulkan_queue) >= point.value;
+}
+
+uint64_t VulkanScheduler::get_completed_value(VulkanQueue *vulkan_queue) const {
+    if (vulkan_queue == nullptr) {
+        throw std::runtime_error("vulkan_queue was nullptr!");
+    }
+
+    uint64_t value = 0;
+    VkResult result = vkGetSemaphoreCounterValue(vk_device, vulkan_queue->get_vk_timeline(), &value);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vkGetSemaphoreCounterValue failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vkGetSemaphoreCounterValue failed! Please check the log above for more info!");
+    }
+
+    return value;
+}
+
+VulkanScheduler::TimelinePoint VulkanScheduler::get_submitted_point(VulkanQueue *vulkan_queue) {
+    if (vulkan_queue == nullptr) {
+        throw std::runtime_error("vulkan_queue was nullptr!");
+    }
+
+    TimelinePoint point;
+    {
+        point.vulkan_queue = vulkan_queue;
+        point.value = vulkan_queue->get_timeline_value();
+    }
+
+    return point;
+}
+
+std::vector<VulkanScheduler::TimelinePoint> VulkanScheduler::get_submitted_points() const {
+    std::vector<TimelinePoint> points;
+    points.reserve(vulkan_queues.size());
+
+    for (auto vulkan_queue : vulkan_queues) {
+        points.push_back(get_submitted_point(vulkan_queue));
+    }
+
+    return points;
+}
+
+void VulkanScheduler::flush_all() const {
+    for (auto vulkan_queue : vulkan_queues) {
+        vulkan_queue->flush_submits();
+    }
+}
@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_SCHEDULER_HPP
+#define MANA_VULKAN_SCHEDULER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanQueue;
+
+    // Every VulkanQueue owns a timeline semaphore that each of its submissions signals with a new value
+    // Work is then identified by a (queue, value) pair, which can be waited on by the CPU or another queue
+    // This replaces per-submission fences, there's nothing to reset and any number of waiters can share a point
+    class VulkanScheduler {
+    public:
+        struct TimelinePoint {
+            VulkanQueue *vulkan_queue = nullptr;
+            uint64_t value = 0;
+
+            [[nodiscard]]
+            bool is_valid() const {
+                return vulkan_queue != nullptr;
+            }
+        };
+
+        // A GPU side wait, the stage flags are the stages that are blocked until the point is reached
+        struct TimelineWait {
+            TimelinePoint point;
+            VkPipelineStageFlags vk_stage_flags = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        };
+
+    protected:
+        VkDevice vk_device = nullptr;
+        std::vector<VulkanQueue*> vulkan_queues;
+
+    public:
+        VulkanScheduler(VkDevice vk_device, const std::vector<VulkanQueue*>& queues);
+
+        void release();
+
+        // Sends every batched submission on every queue to the GPU
+        void flush_all() const;
+
+        //
+        // CPU synchronization
+        // Points that are still batched get flushed before waiting on them
+        //
+
+        // Returns false if the timeout elapsed before the point was reached
+        bool wait(const TimelinePoint& point, uint64_t timeout = UINT64_MAX) const;
+        bool wait_all(const std::vector<TimelinePoint>& points, uint64_t timeout = UINT64_MAX) const;
+
+        [[nodiscard]]
+        bool is_complete(const TimelinePoint& point) const;
+
+        [[nodiscard]]
+        uint64_t get_completed_value(VulkanQueue *vulkan_queue) const;
+
+        // The point that completes once everything submitted to the queue so far has finished
+        [[nodiscard]]
+        static TimelinePoint get_submitted_point(VulkanQueue *vulkan_queue);
+
+        // The submitted point of every queue, once all are reached the device has caught up with the CPU
+        [[nodiscard]]
+        std::vector<TimelinePoint> get_submitted_points() const;
+    };
+}
+
+#endif//MANA_VULKAN_SCHEDULER_HPP
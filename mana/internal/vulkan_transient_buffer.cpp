@@ -0,0 +1,153 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_transient_buffer.hpp"
+
+#include <mana/internal/vulkan_buffer.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace ManaVK::Internal;
+
+VulkanTransientBuffer::VulkanTransientBuffer(VulkanInstance *vulkan_instance, VkDeviceSize block_size) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (block_size == 0) {
+        throw std::runtime_error("block_size was 0!");
+    }
+
+    this->block_size = block_size;
+
+    VkPhysicalDeviceProperties properties {};
+    vkGetPhysicalDeviceProperties(vulkan_instance->get_vk_gpu(), &properties);
+
+    // Both limits are guaranteed to be powers of two
+    min_alignment = std::max(
+        properties.limits.minUniformBufferOffsetAlignment,
+        properties.limits.minStorageBufferOffsetAlignment
+    );
+
+    min_alignment = std::max<VkDeviceSize>(min_alignment, 16);
+}
+
+VulkanTransientBuffer::Allocation VulkanTransientBuffer::allocate(VulkanInstance *vulkan_instance, VkDeviceSize size, VkDeviceSize alignment) {
+    if (alignment == 0) {
+        alignment = min_alignment;
+    }
+
+    while (true) {
+        if (block_index < blocks.size()) {
+            VulkanBuffer *block = blocks[block_index].get();
+
+            VkDeviceSize aligned = (offset + alignment - 1) & ~(alignment - 1);
+
+            if (aligned + size <= block->get_size()) {
+                offset = aligned + size;
+
+                Allocation allocation;
+                {
+                    allocation.vulkan_buffer = block;
+                    allocation.vk_buffer = block->get_vk_buffer();
+                    allocation.offset = aligned;
+                    allocation.size = size;
+                    allocation.data = static_cast<uint8_t*>(block->get_mapped_data()) + aligned;
+                }
+
+                return allocation;
+            }
+
+            // Doesn't fit, move onto the next block (or create one below)
+            block_index++;
+            offset = 0;
+
+            continue;
+        }
+
+        if (vulkan_instance == nullptr) {
+            throw std::runtime_error("vulkan_instance was nullptr!");
+        }
+
+        // Oversized requests get a block of their own
+        VulkanBuffer::BufferSettings settings;
+        {
+            settings.size = std::max(block_size, size + alignment);
+
+            settings.vk_usage_flags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+                | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+            settings.memory_usage = VulkanBuffer::MemoryUsage::Stream;
+            settings.persistent_map = true;
+        }
+
+        blocks.emplace_back(std::make_unique<VulkanBuffer>(vulkan_instance, settings));
+    }
+}
+
+void VulkanTransientBuffer::flush(VulkanInstance *vulkan_instance) {
+    if (blocks.empty()) {
+        return;
+    }
+
+    for (size_t b = flushed_index; b <= block_index && b < blocks.size(); b++) {
+        VulkanBuffer *block = blocks[b].get();
+
+        if (block->is_coherent()) {
+            continue;
+        }
+
+        VkDeviceSize begin = (b == flushed_index) ? flushed_offset : 0;
+        VkDeviceSize end = (b == block_index) ? offset : block->get_size();
+
+        if (end > begin) {
+            block->mark_dirty(begin, end - begin);
+            block->flush(vulkan_instance);
+        }
+    }
+
+    flushed_index = block_index;
+    flushed_offset = offset;
+}
+
+void VulkanTransientBuffer::reset() {
+    block_index = 0;
+    offset = 0;
+
+    flushed_index = 0;
+    flushed_offset = 0;
+}
+
+void VulkanTransientBuffer::release(VulkanInstance *vulkan_instance) {
+    for (auto &block : blocks) {
+        block->release(vulkan_instance);
+    }
+
+    blocks.clear();
+    reset();
+}
@@ -0,0 +1,101 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_TRANSIENT_BUFFER_HPP
+#define MANA_VULKAN_TRANSIENT_BUFFER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mana/internal/vulkan_buffer.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanInstance;
+
+    // A linear allocator for GPU visible data that only lives for a single frame, e.g. per draw constants
+    // Each frame slot owns one, it's reset once the slot's timeline points have been reached
+    //
+    // Blocks are large persistently mapped Stream buffers, so an allocation is just an offset bump
+    // Like VulkanFrameArena, running out of space adds another block, and blocks are kept across resets
+    // Only the recording thread may allocate
+    class VulkanTransientBuffer {
+    public:
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+        struct Allocation {
+            VulkanBuffer *vulkan_buffer = nullptr;
+            VkBuffer vk_buffer = nullptr;
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = 0;
+
+            // Write through this, it's flushed for you before the frame is submitted
+            void *data = nullptr;
+        };
+
+    protected:
+        std::vector<std::unique_ptr<VulkanBuffer>> blocks;
+        VkDeviceSize block_size;
+
+        // Satisfies both uniform and storage buffer offset requirements
+        VkDeviceSize min_alignment;
+
+        size_t block_index = 0;
+        VkDeviceSize offset = 0;
+
+        // How far flush() got, everything past this is still unflushed
+        size_t flushed_index = 0;
+        VkDeviceSize flushed_offset = 0;
+
+    public:
+        VulkanTransientBuffer(VulkanInstance *vulkan_instance, VkDeviceSize block_size = DEFAULT_BLOCK_SIZE);
+
+        // An alignment of 0 uses the device's minimum dynamic offset alignment
+        Allocation allocate(VulkanInstance *vulkan_instance, VkDeviceSize size, VkDeviceSize alignment = 0);
+
+        // Flushes everything allocated since the last flush, free on coherent memory
+        void flush(VulkanInstance *vulkan_instance);
+
+        // Everything allocated before this is invalid afterwards!
+        void reset();
+
+        void release(VulkanInstance *vulkan_instance);
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        size_t get_block_count() const {
+            return blocks.size();
+        }
+
+        [[nodiscard]]
+        VkDeviceSize get_min_alignment() const {
+            return min_alignment;
+        }
+    };
+}
+
+#endif//MANA_VULKAN_TRANSIENT_BUFFER_HPP
@@ -0,0 +1,783 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_upload_engine.hpp"
+
+#include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_cmd_pool.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_queue.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+using namespace ManaVK::Internal;
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Internal::VulkanUploadEngine]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+// Satisfies the offset rules of vkCmdCopyBufferToImage for every format we can upload, block compressed included
+static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+VulkanUploadEngine::VulkanUploadEngine(VulkanInstance *vulkan_instance, const EngineConfig &config)
+    : config(config)
+{
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (vulkan_instance->get_queue_transfer() == nullptr) {
+        throw std::runtime_error("The upload engine requires a transfer queue!");
+    }
+
+    if (config.staging_size == 0 || config.frame_budget == 0) {
+        throw std::runtime_error("staging_size and frame_budget must be larger than 0!");
+    }
+
+    VkBufferCreateInfo buffer_info {};
+    {
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+
+        buffer_info.size = config.staging_size;
+        buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    // Only ever written sequentially by the CPU, so write combined memory is fine
+    VmaAllocationCreateInfo vma_alloc_info {};
+    {
+        vma_alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+        vma_alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    }
+
+    VmaAllocationInfo vma_allocation_info {};
+
+    VkResult result = vmaCreateBuffer(vulkan_instance->get_vma_allocator(), &buffer_info, &vma_alloc_info, &vk_staging_buffer, &vma_staging_allocation, &vma_allocation_info);
+
+    if (result != VK_SUCCESS) {
+        LOG("Error: vmaCreateBuffer failed with error code (" << string_VkResult(result) << ")");
+        throw std::runtime_error("vmaCreateBuffer failed! Please check the log above for more info!");
+    }
+
+    staging_data = static_cast<uint8_t*>(vma_allocation_info.pMappedData);
+}
+
+//
+// Enqueueing
+//
+void VulkanUploadEngine::enqueue_buffer(const BufferUpload &upload, const void *data, VkDeviceSize size, Priority priority, CompletionFunc on_complete) {
+    if (upload.vk_buffer == nullptr) {
+        throw std::runtime_error("vk_buffer was nullptr!");
+    }
+
+    if (data == nullptr || size == 0) {
+        throw std::runtime_error("Buffer uploads require data!");
+    }
+
+    PendingUpload pending;
+    {
+        pending.buffer = upload;
+
+        pending.data.resize(size);
+        std::memcpy(pending.data.data(), data, size);
+
+        pending.on_complete = std::move(on_complete);
+    }
+
+    std::lock_guard<std::mutex> lock(pending_mutex);
+
+    pending_uploads[static_cast<size_t>(priority)].push_back(std::move(pending));
+    pending_bytes += size;
+}
+
+void VulkanUploadEngine::enqueue_image(const ImageUpload &upload, const void *data, VkDeviceSize size, Priority priority, CompletionFunc on_complete) {
+    if (upload.vk_image == nullptr) {
+        throw std::runtime_error("vk_image was nullptr!");
+    }
+
+    if (data == nullptr || size == 0) {
+        throw std::runtime_error("Image uploads require data!");
+    }
+
+    // Images are copied in one go, so they must fit in the ring
+    if (size > config.staging_size - STAGING_ALIGNMENT) {
+        throw std::runtime_error("Image upload is larger than the staging ring! Please increase staging_size!");
+    }
+
+    if (upload.generate_mips && upload.mip_level != 0) {
+        throw std::runtime_error("Mips can only be generated from mip level 0!");
+    }
+
+    PendingUpload pending;
+    {
+        pending.is_image = true;
+        pending.image = upload;
+
+        pending.data.resize(size);
+        std::memcpy(pending.data.data(), data, size);
+
+        pending.on_complete = std::move(on_complete);
+    }
+
+    std::lock_guard<std::mutex> lock(pending_mutex);
+
+    pending_uploads[static_cast<size_t>(priority)].push_back(std::move(pending));
+    pending_bytes += size;
+}
+
+void VulkanUploadEngine::cancel_buffer(VkBuffer vk_buffer) {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+
+    for (auto &pending_list : pending_uploads) {
+        auto iter = pending_list.begin();
+
+        while (iter != pending_list.end()) {
+            if (!iter->is_image && iter->buffer.vk_buffer == vk_buffer) {
+                pending_bytes -= iter->data.size() - iter->uploaded;
+                iter = pending_list.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+    }
+}
+
+//
+// Processing
+//
+bool VulkanUploadEngine::ring_allocate(VkDeviceSize size, VkDeviceSize &offset) {
+    VkDeviceSize aligned = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+    if (ring_head == ring_tail) {
+        ring_head = 0;
+        ring_tail = 0;
+    }
+
+    if (ring_head >= ring_tail) {
+        if (ring_head + aligned <= config.staging_size) {
+            offset = ring_head;
+            ring_head += aligned;
+            return true;
+        }
+
+        // Wrap around, the space left at the end is reclaimed along with the batch before it
+        if (aligned < ring_tail) {
+            offset = 0;
+            ring_head = aligned;
+            return true;
+        }
+
+        return false;
+    }
+
+    if (ring_head + aligned < ring_tail) {
+        offset = ring_head;
+        ring_head += aligned;
+        return true;
+    }
+
+    return false;
+}
+
+std::unique_ptr<VulkanCmdPool> VulkanUploadEngine::take_pool(VulkanInstance *vulkan_instance, std::vector<std::unique_ptr<VulkanCmdPool>> &free_pools, VulkanQueue *vulkan_queue) {
+    if (free_pools.empty()) {
+        return vulkan_queue->create_cmd_pool(vulkan_instance->get_vk_device());
+    }
+
+    std::unique_ptr<VulkanCmdPool> pool = std::move(free_pools.back());
+    free_pools.pop_back();
+
+    return pool;
+}
+
+void VulkanUploadEngine::collect_completed(VulkanInstance *vulkan_instance) {
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+    VulkanScheduler *scheduler = vulkan_instance->get_scheduler();
+
+    // Batches complete in order, so we can stop at the first one that isn't done
+    while (!in_flight.empty() && scheduler->is_complete(in_flight.front().timeline_point)) {
+        UploadBatch &batch = in_flight.front();
+
+        for (auto &on_complete : batch.completions) {
+            if (on_complete) {
+                on_complete();
+            }
+        }
+
+        batch.transfer_pool->reset(vk_device);
+        free_transfer_pools.push_back(std::move(batch.transfer_pool));
+
+        if (batch.graphics_pool != nullptr) {
+            batch.graphics_pool->reset(vk_device);
+            free_graphics_pools.push_back(std::move(batch.graphics_pool));
+        }
+
+        ring_tail = batch.ring_end;
+        in_flight.pop_front();
+    }
+}
+
+void VulkanUploadEngine::process(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    collect_completed(vulkan_instance);
+
+    VulkanQueue *queue_transfer = vulkan_instance->get_queue_transfer();
+    VulkanQueue *queue_graphics = vulkan_instance->get_queue_graphics();
+
+    // Exclusive resources have to change hands explicitly between families
+    bool transfer_ownership = queue_transfer->get_index() != queue_graphics->get_index();
+
+    uint32_t src_family = transfer_ownership ? queue_transfer->get_index() : VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dst_family = transfer_ownership ? queue_graphics->get_index() : VK_QUEUE_FAMILY_IGNORED;
+
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+
+    UploadBatch batch;
+    VulkanCmdBuffer *transfer_cmd = nullptr;
+
+    release_buffer_barriers.clear();
+    release_image_barriers.clear();
+    acquire_buffer_barriers.clear();
+    acquire_image_barriers.clear();
+
+    mip_jobs.clear();
+
+    VkDeviceSize budget = config.frame_budget;
+    VkDeviceSize recorded = 0;
+
+    // Large buffers are split so they can't hog the ring, and so the budget can be honored
+    VkDeviceSize max_chunk = config.staging_size / 4;
+
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+
+        bool stalled = false;
+        for (auto &pending_list : pending_uploads) {
+            while (!stalled && !pending_list.empty()) {
+                PendingUpload &pending = pending_list.front();
+
+                VkDeviceSize remaining = pending.data.size() - pending.uploaded;
+                VkDeviceSize size = remaining;
+
+                if (!pending.is_image) {
+                    size = std::min(size, max_chunk);
+                }
+
+                // The first upload always goes through, otherwise a large image could never make it
+                if (recorded > 0 && recorded + size > budget) {
+                    if (pending.is_image || recorded >= budget) {
+                        stalled = true;
+                        break;
+                    }
+
+                    size = budget - recorded;
+                }
+
+                VkDeviceSize offset = 0;
+                if (!ring_allocate(size, offset)) {
+                    // Still in use by earlier batches, try again next time
+                    stalled = true;
+                    break;
+                }
+
+                if (transfer_cmd == nullptr) {
+                    batch.transfer_pool = take_pool(vulkan_instance, free_transfer_pools, queue_transfer);
+
+                    transfer_cmd = batch.transfer_pool->next_cmd_buffer(vk_device);
+                    transfer_cmd->begin(vulkan_instance);
+                }
+
+                std::memcpy(staging_data + offset, pending.data.data() + pending.uploaded, size);
+
+                if (pending.is_image) {
+                    const ImageUpload &image = pending.image;
+
+                    // Generated levels are written by the blit chain, so they go through the same transitions
+                    bool generate_mips = image.generate_mips && image.mip_levels > 1;
+
+                    VkImageSubresourceRange range {};
+                    {
+                        range.aspectMask = image.vk_aspect_flags;
+                        range.baseMipLevel = image.mip_level;
+                        range.levelCount = generate_mips ? image.mip_levels : 1;
+                        range.baseArrayLayer = image.base_layer;
+                        range.layerCount = image.layer_count;
+                    }
+
+                    // The old contents are discarded, so the transition doesn't have to wait on anything
+                    VkImageMemoryBarrier to_transfer {};
+                    {
+                        to_transfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+                        to_transfer.srcAccessMask = 0;
+                        to_transfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+                        to_transfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                        to_transfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+                        to_transfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                        to_transfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+                        to_transfer.image = image.vk_image;
+                        to_transfer.subresourceRange = range;
+                    }
+
+                    vkCmdPipelineBarrier(
+                        transfer_cmd->get_vk_cmd_buffer(),
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        0,
+                        0, nullptr,
+                        0, nullptr,
+                        1, &to_transfer
+                    );
+
+                    VkBufferImageCopy region {};
+                    {
+                        region.bufferOffset = offset;
+
+                        region.imageSubresource.aspectMask = image.vk_aspect_flags;
+                        region.imageSubresource.mipLevel = image.mip_level;
+                        region.imageSubresource.baseArrayLayer = image.base_layer;
+                        region.imageSubresource.layerCount = image.layer_count;
+
+                        region.imageExtent = image.vk_extent;
+                    }
+
+                    vkCmdCopyBufferToImage(transfer_cmd->get_vk_cmd_buffer(), vk_staging_buffer, image.vk_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+                    // Mip chains stay in TRANSFER_DST, record_mip_jobs() takes them to their final layout
+                    VkImageLayout vk_release_layout = generate_mips ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : image.vk_final_layout;
+                    VkAccessFlags vk_release_access = generate_mips ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT : image.vk_dst_access;
+
+                    // Release and acquire must describe the same transition
+                    VkImageMemoryBarrier release {};
+                    {
+                        release.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+                        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                        release.dstAccessMask = transfer_ownership ? 0 : vk_release_access;
+
+                        release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                        release.newLayout = vk_release_layout;
+
+                        release.srcQueueFamilyIndex = src_family;
+                        release.dstQueueFamilyIndex = dst_family;
+
+                        release.image = image.vk_image;
+                        release.subresourceRange = range;
+                    }
+
+                    release_image_barriers.push_back(release);
+
+                    if (transfer_ownership) {
+                        VkImageMemoryBarrier acquire = release;
+                        {
+                            acquire.srcAccessMask = 0;
+                            acquire.dstAccessMask = vk_release_access;
+                        }
+
+                        acquire_image_barriers.push_back(acquire);
+                    }
+
+                    if (generate_mips) {
+                        MipJob job;
+                        {
+                            job.vk_image = image.vk_image;
+                            job.vk_extent = image.vk_extent;
+
+                            job.vk_aspect_flags = image.vk_aspect_flags;
+                            job.base_layer = image.base_layer;
+                            job.layer_count = image.layer_count;
+
+                            job.mip_levels = image.mip_levels;
+                            job.blit_levels = image.mip_levels;
+
+                            job.vk_final_layout = image.vk_final_layout;
+                            job.vk_dst_stages = image.vk_dst_stages;
+                            job.vk_dst_access = image.vk_dst_access;
+                        }
+
+                        VkFormatProperties format_properties {};
+                        vkGetPhysicalDeviceFormatProperties(vulkan_instance->get_vk_gpu(), image.vk_format, &format_properties);
+
+                        VkFormatFeatureFlags features = format_properties.optimalTilingFeatures;
+
+                        if (!(features & VK_FORMAT_FEATURE_BLIT_SRC_BIT) || !(features & VK_FORMAT_FEATURE_BLIT_DST_BIT)) {
+                            LOG("Warning: Format '" << string_VkFormat(image.vk_format) << "' can't be blitted, mips won't be generated!");
+                            job.blit_levels = 1;
+                        } else if (!(features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+                            // e.g. integer formats, point sampling is still far better than undefined levels
+                            job.vk_filter = VK_FILTER_NEAREST;
+                        }
+
+                        mip_jobs.push_back(job);
+                    }
+                } else {
+                    const BufferUpload &buffer = pending.buffer;
+
+                    VkBufferCopy region {};
+                    {
+                        region.srcOffset = offset;
+                        region.dstOffset = buffer.offset + pending.uploaded;
+                        region.size = size;
+                    }
+
+                    vkCmdCopyBuffer(transfer_cmd->get_vk_cmd_buffer(), vk_staging_buffer, buffer.vk_buffer, 1, &region);
+
+                    VkBufferMemoryBarrier release {};
+                    {
+                        release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+
+                        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                        release.dstAccessMask = transfer_ownership ? 0 : buffer.vk_dst_access;
+
+                        release.srcQueueFamilyIndex = src_family;
+                        release.dstQueueFamilyIndex = dst_family;
+
+                        release.buffer = buffer.vk_buffer;
+                        release.offset = region.dstOffset;
+                        release.size = size;
+                    }
+
+                    release_buffer_barriers.push_back(release);
+
+                    if (transfer_ownership) {
+                        VkBufferMemoryBarrier acquire = release;
+                        {
+                            acquire.srcAccessMask = 0;
+                            acquire.dstAccessMask = buffer.vk_dst_access;
+                        }
+
+                        acquire_buffer_barriers.push_back(acquire);
+                    }
+                }
+
+                recorded += size;
+                pending.uploaded += size;
+                pending_bytes -= size;
+
+                if (pending.uploaded == pending.data.size()) {
+                    batch.completions.push_back(std::move(pending.on_complete));
+                    pending_list.pop_front();
+                }
+            }
+        }
+    }
+
+    if (transfer_cmd == nullptr) {
+        return;
+    }
+
+    vmaFlushAllocation(vulkan_instance->get_vma_allocator(), vma_staging_allocation, 0, VK_WHOLE_SIZE);
+
+    //
+    // Release
+    //
+    // Without an ownership transfer this is the only barrier, so it has to cover the graphics stages directly
+    VkPipelineStageFlags release_dst_stages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+    if (!transfer_ownership) {
+        release_dst_stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+
+    vkCmdPipelineBarrier(
+        transfer_cmd->get_vk_cmd_buffer(),
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        release_dst_stages,
+        0,
+        0, nullptr,
+        static_cast<uint32_t>(release_buffer_barriers.size()), release_buffer_barriers.data(),
+        static_cast<uint32_t>(release_image_barriers.size()), release_image_barriers.data()
+    );
+
+    // The transfer queue is the graphics family here, so it can blit
+    if (!transfer_ownership) {
+        record_mip_jobs(transfer_cmd->get_vk_cmd_buffer());
+    }
+
+    transfer_cmd->end(vulkan_instance);
+
+    VulkanCmdBuffer::SubmitInfo transfer_submit {};
+    batch.timeline_point = transfer_cmd->submit(transfer_submit);
+
+    //
+    // Acquire
+    //
+    // Waits on the transfer timeline GPU side, graphics work submitted after this doesn't inherit the wait
+    if (transfer_ownership) {
+        batch.graphics_pool = take_pool(vulkan_instance, free_graphics_pools, queue_graphics);
+
+        VulkanCmdBuffer *graphics_cmd = batch.graphics_pool->next_cmd_buffer(vk_device);
+        graphics_cmd->begin(vulkan_instance);
+
+        vkCmdPipelineBarrier(
+            graphics_cmd->get_vk_cmd_buffer(),
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0,
+            0, nullptr,
+            static_cast<uint32_t>(acquire_buffer_barriers.size()), acquire_buffer_barriers.data(),
+            static_cast<uint32_t>(acquire_image_barriers.size()), acquire_image_barriers.data()
+        );
+
+        record_mip_jobs(graphics_cmd->get_vk_cmd_buffer());
+
+        graphics_cmd->end(vulkan_instance);
+
+        VulkanCmdBuffer::SubmitInfo graphics_submit {};
+        {
+            VulkanScheduler::TimelineWait wait;
+            {
+                wait.point = batch.timeline_point;
+                wait.vk_stage_flags = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            }
+
+            graphics_submit.timeline_waits.push_back(wait);
+        }
+
+        // The graphics queue is flushed along with the next frame
+        batch.timeline_point = graphics_cmd->submit(graphics_submit);
+    }
+
+    queue_transfer->flush_submits();
+
+    batch.ring_end = ring_head;
+    in_flight.push_back(std::move(batch));
+}
+
+void VulkanUploadEngine::record_mip_jobs(VkCommandBuffer vk_cmd_buffer) {
+    if (mip_jobs.empty()) {
+        return;
+    }
+
+    uint32_t max_levels = 1;
+    VkPipelineStageFlags vk_dst_stages = 0;
+
+    for (const auto &job : mip_jobs) {
+        max_levels = std::max(max_levels, job.blit_levels);
+        vk_dst_stages |= job.vk_dst_stages;
+    }
+
+    //
+    // Blit chain
+    //
+    // Each level is read from the one above it, so every image advances one level per step
+    for (uint32_t level = 1; level < max_levels; level++) {
+        mip_barriers.clear();
+        mip_blits.clear();
+
+        for (const auto &job : mip_jobs) {
+            if (level >= job.blit_levels) {
+                continue;
+            }
+
+            VkImageMemoryBarrier barrier {};
+            {
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+                barrier.image = job.vk_image;
+
+                barrier.subresourceRange.aspectMask = job.vk_aspect_flags;
+                barrier.subresourceRange.baseMipLevel = level - 1;
+                barrier.subresourceRange.levelCount = 1;
+                barrier.subresourceRange.baseArrayLayer = job.base_layer;
+                barrier.subresourceRange.layerCount = job.layer_count;
+            }
+
+            mip_barriers.push_back(barrier);
+
+            VkImageBlit blit {};
+            {
+                blit.srcOffsets[1].x = static_cast<int32_t>(std::max(job.vk_extent.width >> (level - 1), 1u));
+                blit.srcOffsets[1].y = static_cast<int32_t>(std::max(job.vk_extent.height >> (level - 1), 1u));
+                blit.srcOffsets[1].z = static_cast<int32_t>(std::max(job.vk_extent.depth >> (level - 1), 1u));
+
+                blit.srcSubresource.aspectMask = job.vk_aspect_flags;
+                blit.srcSubresource.mipLevel = level - 1;
+                blit.srcSubresource.baseArrayLayer = job.base_layer;
+                blit.srcSubresource.layerCount = job.layer_count;
+
+                blit.dstOffsets[1].x = static_cast<int32_t>(std::max(job.vk_extent.width >> level, 1u));
+                blit.dstOffsets[1].y = static_cast<int32_t>(std::max(job.vk_extent.height >> level, 1u));
+                blit.dstOffsets[1].z = static_cast<int32_t>(std::max(job.vk_extent.depth >> level, 1u));
+
+                blit.dstSubresource = blit.srcSubresource;
+                blit.dstSubresource.mipLevel = level;
+            }
+
+            mip_blits.push_back(blit);
+        }
+
+        vkCmdPipelineBarrier(
+            vk_cmd_buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            static_cast<uint32_t>(mip_barriers.size()), mip_barriers.data()
+        );
+
+        // Blits into different images can't share a call, but they no longer wait on each other
+        size_t blit_index = 0;
+        for (const auto &job : mip_jobs) {
+            if (level >= job.blit_levels) {
+                continue;
+            }
+
+            vkCmdBlitImage(
+                vk_cmd_buffer,
+                job.vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                job.vk_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &mip_blits[blit_index++],
+                job.vk_filter
+            );
+        }
+    }
+
+    //
+    // Final layouts
+    //
+    // Every level but the last blitted one was a blit source
+    mip_barriers.clear();
+
+    for (const auto &job : mip_jobs) {
+        VkImageMemoryBarrier barrier {};
+        {
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+            barrier.dstAccessMask = job.vk_dst_access;
+            barrier.newLayout = job.vk_final_layout;
+
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            barrier.image = job.vk_image;
+
+            barrier.subresourceRange.aspectMask = job.vk_aspect_flags;
+            barrier.subresourceRange.baseArrayLayer = job.base_layer;
+            barrier.subresourceRange.layerCount = job.layer_count;
+        }
+
+        if (job.blit_levels > 1) {
+            VkImageMemoryBarrier sources = barrier;
+            {
+                sources.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+                sources.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+                sources.subresourceRange.baseMipLevel = 0;
+                sources.subresourceRange.levelCount = job.blit_levels - 1;
+            }
+
+            mip_barriers.push_back(sources);
+        }
+
+        VkImageMemoryBarrier rest = barrier;
+        {
+            rest.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            rest.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+            rest.subresourceRange.baseMipLevel = job.blit_levels - 1;
+            rest.subresourceRange.levelCount = job.mip_levels - (job.blit_levels - 1);
+        }
+
+        mip_barriers.push_back(rest);
+    }
+
+    vkCmdPipelineBarrier(
+        vk_cmd_buffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        vk_dst_stages,
+        0,
+        0, nullptr,
+        0, nullptr,
+        static_cast<uint32_t>(mip_barriers.size()), mip_barriers.data()
+    );
+}
+
+void VulkanUploadEngine::release(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr! Can't release Vulkan resources, this is a memory leak!");
+    }
+
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+
+    for (auto &batch : in_flight) {
+        vulkan_instance->get_scheduler()->wait(batch.timeline_point);
+
+        free_transfer_pools.push_back(std::move(batch.transfer_pool));
+
+        if (batch.graphics_pool != nullptr) {
+            free_graphics_pools.push_back(std::move(batch.graphics_pool));
+        }
+    }
+
+    in_flight.clear();
+
+    for (auto &pool : free_transfer_pools) {
+        pool->release(vk_device);
+    }
+
+    for (auto &pool : free_graphics_pools) {
+        pool->release(vk_device);
+    }
+
+    free_transfer_pools.clear();
+    free_graphics_pools.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+
+        for (auto &pending_list : pending_uploads) {
+            pending_list.clear();
+        }
+
+        pending_bytes = 0;
+    }
+
+    if (vk_staging_buffer != nullptr) {
+        vmaDestroyBuffer(vulkan_instance->get_vma_allocator(), vk_staging_buffer, vma_staging_allocation);
+
+        vk_staging_buffer = nullptr;
+        vma_staging_allocation = nullptr;
+        staging_data = nullptr;
+    }
+}
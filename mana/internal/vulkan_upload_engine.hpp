@@ -0,0 +1,231 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_VULKAN_UPLOAD_ENGINE_HPP
+#define MANA_VULKAN_UPLOAD_ENGINE_HPP
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <mana/internal/vulkan_cmd_pool.hpp>
+#include <mana/internal/vulkan_scheduler.hpp>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ManaVK::Internal {
+    class VulkanInstance;
+    class VulkanQueue;
+
+    // Streams data into device local buffers and images through the transfer queue
+    // The graphics queue never waits on the CPU or the copies, uploads just land a few frames later
+    //
+    // Data is copied into a persistently mapped staging ring, which is reclaimed as batches complete
+    // Every process() call records at most frame_budget bytes, high priority uploads going first
+    // When transfer and graphics are different families, ownership is released on the transfer queue
+    // and acquired on the graphics queue, that acquire only waits on the transfer timeline GPU side
+    //
+    // Enqueueing is thread safe, process() must only ever be called from one thread
+    class VulkanUploadEngine {
+    public:
+        enum class Priority {
+            // Needed as soon as possible, e.g. something already on screen
+            High,
+            Normal,
+
+            // Background streaming, only uses what's left of the budget
+            Low
+        };
+
+        struct EngineConfig {
+            // Size of the staging ring, no single image may be larger than this
+            VkDeviceSize staging_size = 64 * 1024 * 1024;
+
+            // How many bytes process() is allowed to copy each call, at least one upload always goes through
+            VkDeviceSize frame_budget = 8 * 1024 * 1024;
+        };
+
+        struct BufferUpload {
+            VkBuffer vk_buffer = nullptr;
+            VkDeviceSize offset = 0;
+
+            // How the graphics queue will use the buffer once it arrives
+            VkPipelineStageFlags vk_dst_stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            VkAccessFlags vk_dst_access = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        };
+
+        // Uploads a single mip level, the contents of the level are discarded first
+        struct ImageUpload {
+            VkImage vk_image = nullptr;
+            VkFormat vk_format = VK_FORMAT_UNDEFINED;
+            VkExtent3D vk_extent {};
+
+            // Uploading mip 0 with generate_mips fills every other level with a blit chain on the GPU
+            // Requires a graphics capable queue, so this runs on the graphics queue after the ownership transfer
+            bool generate_mips = false;
+            uint32_t mip_levels = 1;
+
+            VkImageAspectFlags vk_aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+            uint32_t mip_level = 0;
+            uint32_t base_layer = 0;
+            uint32_t layer_count = 1;
+
+            // The layout the image is left in, along with how the graphics queue will use it
+            VkImageLayout vk_final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            VkPipelineStageFlags vk_dst_stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            VkAccessFlags vk_dst_access = VK_ACCESS_SHADER_READ_BIT;
+        };
+
+        // Called from process() once the graphics queue can safely use the destination
+        using CompletionFunc = std::function<void()>;
+
+    protected:
+        struct PendingUpload {
+            bool is_image = false;
+
+            BufferUpload buffer;
+            ImageUpload image;
+
+            // Owned copy of the source data, large buffers are uploaded in chunks across several batches
+            std::vector<uint8_t> data;
+            VkDeviceSize uploaded = 0;
+
+            CompletionFunc on_complete;
+        };
+
+        // A mip chain recorded once its first level has arrived
+        struct MipJob {
+            VkImage vk_image = nullptr;
+            VkExtent3D vk_extent {};
+
+            VkImageAspectFlags vk_aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+            uint32_t base_layer = 0;
+            uint32_t layer_count = 1;
+
+            uint32_t mip_levels = 1;
+
+            // Levels the blit chain fills, 1 when the format can't be blitted at all
+            uint32_t blit_levels = 1;
+            VkFilter vk_filter = VK_FILTER_LINEAR;
+
+            VkImageLayout vk_final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            VkPipelineStageFlags vk_dst_stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            VkAccessFlags vk_dst_access = VK_ACCESS_SHADER_READ_BIT;
+        };
+
+        struct UploadBatch {
+            std::unique_ptr<VulkanCmdPool> transfer_pool;
+
+            // Only used when ownership has to be acquired on the graphics queue
+            std::unique_ptr<VulkanCmdPool> graphics_pool;
+
+            // Where the ring head was after this batch, the tail moves here once it completes
+            VkDeviceSize ring_end = 0;
+
+            // Reached once the destinations are usable by the graphics queue
+            VulkanScheduler::TimelinePoint timeline_point;
+
+            std::vector<CompletionFunc> completions;
+        };
+
+        EngineConfig config;
+
+        VkBuffer vk_staging_buffer = nullptr;
+        VmaAllocation vma_staging_allocation = nullptr;
+        uint8_t *staging_data = nullptr;
+
+        // Head == tail only ever means the ring is empty, allocations never let the head catch up
+        VkDeviceSize ring_head = 0;
+        VkDeviceSize ring_tail = 0;
+
+        // Guards the pending lists, enqueueing happens from loading threads
+        std::mutex pending_mutex;
+        std::array<std::deque<PendingUpload>, 3> pending_uploads;
+        VkDeviceSize pending_bytes = 0;
+
+        std::deque<UploadBatch> in_flight;
+
+        std::vector<std::unique_ptr<VulkanCmdPool>> free_transfer_pools;
+        std::vector<std::unique_ptr<VulkanCmdPool>> free_graphics_pools;
+
+        // Scratch space for barriers, kept around so process() doesn't allocate every call
+        std::vector<VkBufferMemoryBarrier> release_buffer_barriers;
+        std::vector<VkImageMemoryBarrier> release_image_barriers;
+        std::vector<VkBufferMemoryBarrier> acquire_buffer_barriers;
+        std::vector<VkImageMemoryBarrier> acquire_image_barriers;
+
+        std::vector<MipJob> mip_jobs;
+        std::vector<VkImageMemoryBarrier> mip_barriers;
+        std::vector<VkImageBlit> mip_blits;
+
+        // Returns false if the ring has no contiguous space for size bytes right now
+        bool ring_allocate(VkDeviceSize size, VkDeviceSize &offset);
+
+        void collect_completed(VulkanInstance *vulkan_instance);
+
+        // Records every pending mip chain into one sequence, the barriers for each level are shared by all images
+        void record_mip_jobs(VkCommandBuffer vk_cmd_buffer);
+
+        std::unique_ptr<VulkanCmdPool> take_pool(VulkanInstance *vulkan_instance, std::vector<std::unique_ptr<VulkanCmdPool>> &free_pools, VulkanQueue *vulkan_queue);
+
+    public:
+        VulkanUploadEngine(VulkanInstance *vulkan_instance, const EngineConfig &config);
+
+        // The data is copied, it can be freed as soon as this returns
+        void enqueue_buffer(const BufferUpload &upload, const void *data, VkDeviceSize size, Priority priority = Priority::Normal, CompletionFunc on_complete = nullptr);
+        void enqueue_image(const ImageUpload &upload, const void *data, VkDeviceSize size, Priority priority = Priority::Normal, CompletionFunc on_complete = nullptr);
+
+        // Drops every upload to the buffer that hasn't been recorded yet, their completion functions never run
+        // Call before releasing a buffer, anything already recorded was submitted and is covered by the release queue
+        void cancel_buffer(VkBuffer vk_buffer);
+
+        // Runs completion functions for finished batches, then records and submits the next one
+        // Never waits on the GPU
+        void process(VulkanInstance *vulkan_instance);
+
+        // Waits for everything in flight, pending uploads are dropped
+        void release(VulkanInstance *vulkan_instance);
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        VkDeviceSize get_pending_bytes() {
+            std::lock_guard<std::mutex> lock(pending_mutex);
+            return pending_bytes;
+        }
+
+        [[nodiscard]]
+        bool is_idle() {
+            return get_pending_bytes() == 0 && in_flight.empty();
+        }
+    };
+}
+
+#endif//MANA_VULKAN_UPLOAD_ENGINE_HPP
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <mana/internal/vulkan_queue.hpp>
 #include <mana/internal/vulkan_image.hpp>
 #include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_framebuffer_cache.hpp>
 
 #include <vulkan/vulkan.h>
 #include <vulkan/vk_enum_string_helper.h>
@@ -80,8 +81,8 @@ void Internal::VulkanWindow::create_swapchain(VulkanInstance *vulkan_instance, c
         throw std::runtime_error("vulkan_instance was nullptr!");
     }
 
-    if (config.vk_render_pass == nullptr) {
-        throw std::runtime_error("vk_render_pass was nullptr! You can't create a framebuffer without a render pass!");
+    if (config.vulkan_render_pass == nullptr) {
+        throw std::runtime_error("vulkan_render_pass was nullptr! You can't create a framebuffer without a render pass!");
     }
 
     //
@@ -108,6 +109,13 @@ void Internal::VulkanWindow::create_swapchain(VulkanInstance *vulkan_instance, c
         vk_extent = actual_extent;
     }
 
+    // Minimized windows report a zero extent, which we can't create a swapchain for
+    // Keep the old one around and try again once the window is visible
+    if (vulkan_swapchain != nullptr && (vk_extent.width == 0 || vk_extent.height == 0)) {
+        swapchain_dirty = true;
+        return;
+    }
+
     // How many frames can the window render?
     uint32_t image_count = vk_capabilities.minImageCount + 1;
     if (vk_capabilities.maxImageCount > 0 && image_count > vk_capabilities.maxImageCount) {
@@ -172,6 +180,10 @@ void Internal::VulkanWindow::create_swapchain(VulkanInstance *vulkan_instance, c
     //
     // Depth image creation
     //
+    if (config.frames_in_flight == 0) {
+        throw std::runtime_error("frames_in_flight was 0! At least one frame must be in flight!");
+    }
+
     if (config.vk_format_depth.has_value()) {
         Internal::VulkanImage::ImageSettings image_settings;
         {
@@ -183,9 +195,13 @@ void Internal::VulkanWindow::create_swapchain(VulkanInstance *vulkan_instance, c
             image_settings.vk_aspect_flags = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 
             image_settings.generate_mipmaps = false;
+            image_settings.transient = config.depth_transient;
         }
 
-        new_swapchain->vulkan_depth_image = std::make_unique<VulkanImage>(vulkan_instance, image_settings);
+        // Frames in flight can't share a depth buffer, otherwise the next frame would trample the current one
+        for (uint32_t f = 0; f < config.frames_in_flight; f++) {
+            new_swapchain->vulkan_depth_images.emplace_back(std::make_unique<VulkanImage>(vulkan_instance, image_settings));
+        }
     }
 
     //
@@ -233,38 +249,46 @@ void Internal::VulkanWindow::create_swapchain(VulkanInstance *vulkan_instance, c
     //
     // Framebuffer creation
     //
-    {
-        new_swapchain->vk_framebuffers.resize(image_count);
+    auto framebuffer_cache = vulkan_instance->get_framebuffer_cache();
 
-        for (uint32_t i = 0; i < image_count; i++) {
-            std::vector<VkImageView> attachments = {
-                new_swapchain->vk_swapchain_views[i],
-            };
-
-            if (new_swapchain->vulkan_depth_image != nullptr) {
-                attachments.push_back(new_swapchain->vulkan_depth_image->get_vk_view());
-            }
+    if (config.vulkan_render_pass->is_dynamic()) {
+        new_swapchain->dynamic = true;
+    } else if (vulkan_instance->has_imageless_framebuffer()) {
+        VulkanFramebufferCache::FramebufferKey key;
+        {
+            key.vulkan_render_pass = config.vulkan_render_pass;
+            key.vk_extent = vk_extent;
+            key.imageless = true;
 
-            VkFramebufferCreateInfo framebuffer_create_info{};
-            {
-                framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            key.attachments.push_back({config.vk_format_color, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0});
 
-                framebuffer_create_info.renderPass = config.vk_render_pass;
+            if (!new_swapchain->vulkan_depth_images.empty()) {
+                const auto &depth_image = new_swapchain->vulkan_depth_images.front();
+                key.attachments.push_back({depth_image->get_vk_format(), depth_image->get_vk_usage_flags(), 0});
+            }
+        }
 
-                framebuffer_create_info.attachmentCount = static_cast<uint32_t>(attachments.size());
-                framebuffer_create_info.pAttachments = attachments.data();
+        // Recreating at the same extent (e.g. out of date) doesn't create anything, it only takes another reference
+        new_swapchain->vk_framebuffer_imageless = framebuffer_cache->get(vulkan_instance->get_vk_device(), key);
+    } else {
+        uint32_t slot_count = config.frames_in_flight;
+        new_swapchain->vk_framebuffers.resize(slot_count * image_count);
 
-                framebuffer_create_info.width = vk_extent.width;
-                framebuffer_create_info.height = vk_extent.height;
+        for (uint32_t s = 0; s < slot_count; s++) {
+            for (uint32_t i = 0; i < image_count; i++) {
+                VulkanFramebufferCache::FramebufferKey key;
+                {
+                    key.vulkan_render_pass = config.vulkan_render_pass;
+                    key.vk_extent = vk_extent;
 
-                framebuffer_create_info.layers = 1;
-            }
+                    key.vk_views.push_back(new_swapchain->vk_swapchain_views[i]);
 
-            VkResult result = vkCreateFramebuffer(vulkan_instance->get_vk_device(), &framebuffer_create_info, nullptr, &new_swapchain->vk_framebuffers[i]);
+                    if (!new_swapchain->vulkan_depth_images.empty()) {
+                        key.vk_views.push_back(new_swapchain->vulkan_depth_images[s]->get_vk_view());
+                    }
+                }
 
-            if (result != VK_SUCCESS) {
-                LOG("vkCreateFramebuffer failed with error code (" << string_VkResult(result) << ")");
-                throw std::runtime_error("vkCreateFramebuffer failed! Please check the log above for more info!");
+                new_swapchain->vk_framebuffers[(s * image_count) + i] = framebuffer_cache->get(vulkan_instance->get_vk_device(), key);
             }
         }
     }
@@ -272,12 +296,28 @@ void Internal::VulkanWindow::create_swapchain(VulkanInstance *vulkan_instance, c
     //
     // Release and replace previous swapchain info
     //
+    // Frames still in flight may reference the old swapchain, so instead of waiting on them it's retired
+    // The last submission of every frame slot is the last point any of them could have used it
     if (vulkan_swapchain != nullptr) {
-        release_swapchain(vulkan_instance, std::move(vulkan_swapchain));
+        RetiredSwapchain retired;
+        {
+            retired.vulkan_swapchain = std::move(vulkan_swapchain);
+
+            for (const auto& frame : vulkan_frames) {
+                for (const auto& point : frame.timeline_points) {
+                    retired.timeline_points.push_back(point);
+                }
+            }
+        }
+
+        retired_swapchains.emplace_back(std::move(retired));
     }
 
     last_config = config;
     vulkan_swapchain = std::move(new_swapchain);
+
+    swapchain_dirty = false;
+    image_acquired = false;
 }
 
 void Internal::VulkanWindow::create_command_objects(VulkanInstance *vulkan_instance, VulkanQueue *vulkan_queue) {
@@ -289,46 +329,54 @@ void Internal::VulkanWindow::create_command_objects(VulkanInstance *vulkan_insta
         throw std::runtime_error("vulkan_instance was nullptr!");
     }
 
-    vulkan_cmd_buffer = std::shared_ptr<VulkanCmdBuffer>(vulkan_queue->allocate_cmd_buffer(vulkan_instance->get_vk_device()));
-
-    //
-    // Sync object creation
-    //
-    VkSemaphoreCreateInfo semaphore_info{};
-    {
-        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    if (last_config.frames_in_flight == 0) {
+        throw std::runtime_error("frames_in_flight was 0! Have you created the swapchain yet?");
     }
 
-    {
-        VkResult result = vkCreateSemaphore(vulkan_instance->get_vk_device(), &semaphore_info, nullptr, &vk_semaphore_image_ready);
+    vulkan_frames.resize(last_config.frames_in_flight);
+    frame_slot = 0;
 
-        if (result != VK_SUCCESS) {
-            LOG("vkCreateSemaphore failed with error code (" << string_VkResult(result) << ")");
-            throw std::runtime_error("vkCreateSemaphore failed! Please check the log above for more info!");
+    for (auto& frame : vulkan_frames) {
+        VulkanCmdPool::PoolConfig pool_config;
+        {
+            // Target + offscreen
+            pool_config.batch_size = 2;
         }
-    }
 
-    {
-        VkResult result = vkCreateSemaphore(vulkan_instance->get_vk_device(), &semaphore_info, nullptr, &vk_semaphore_work_done);
+        frame.vulkan_cmd_pool = vulkan_queue->create_cmd_pool(vulkan_instance->get_vk_device(), pool_config);
 
-        if (result != VK_SUCCESS) {
-            LOG("vkCreateSemaphore failed with error code (" << string_VkResult(result) << ")");
-            throw std::runtime_error("vkCreateSemaphore failed! Please check the log above for more info!");
+        frame.vulkan_cmd_buffer = frame.vulkan_cmd_pool->next_cmd_buffer(vulkan_instance->get_vk_device());
+        frame.vulkan_cmd_buffer_offscreen = frame.vulkan_cmd_pool->next_cmd_buffer(vulkan_instance->get_vk_device());
+
+        frame.frame_arena = std::make_unique<VulkanFrameArena>();
+        frame.transient_buffer = std::make_unique<VulkanTransientBuffer>(vulkan_instance);
+
+        //
+        // Sync object creation
+        //
+        VkSemaphoreCreateInfo semaphore_info{};
+        {
+            semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
         }
-    }
 
-    VkFenceCreateInfo fence_info {};
-    {
-        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    }
+        {
+            VkResult result = vkCreateSemaphore(vulkan_instance->get_vk_device(), &semaphore_info, nullptr, &frame.vk_semaphore_image_ready);
 
-    {
-        VkResult result = vkCreateFence(vulkan_instance->get_vk_device(), &fence_info, nullptr, &vk_fence);
+            if (result != VK_SUCCESS) {
+                LOG("vkCreateSemaphore failed with error code (" << string_VkResult(result) << ")");
+                throw std::runtime_error("vkCreateSemaphore failed! Please check the log above for more info!");
+            }
+        }
 
-        if (result != VK_SUCCESS) {
-            LOG("vkCreateFence failed with error code (" << string_VkResult(result) << ")");
-            throw std::runtime_error("vkCreateFence failed! Please check the log above for more info!");
+        {
+            VkResult result = vkCreateSemaphore(vulkan_instance->get_vk_device(), &semaphore_info, nullptr, &frame.vk_semaphore_work_done);
+
+            if (result != VK_SUCCESS) {
+                LOG("vkCreateSemaphore failed with error code (" << string_VkResult(result) << ")");
+                throw std::runtime_error("vkCreateSemaphore failed! Please check the log above for more info!");
+            }
         }
+
     }
 }
 
@@ -356,18 +404,139 @@ void Internal::VulkanWindow::release_swapchain(VulkanInstance *vulkan_instance,
 
     //
     // Deallocation (immediate, you're responsible for the syncing)
+    // Retired swapchains go through collect_retired_swapchains() instead
     //
     if (actual->vk_swapchain != nullptr) {
+        // Imageless framebuffers don't reference any views, they're shared by every swapchain of the same extent
+        // Each swapchain holds a reference from create_swapchain(), the cache destroys it with the last one (from any window)
+        if (actual->vk_framebuffer_imageless != nullptr) {
+            vulkan_instance->get_framebuffer_cache()->release_imageless(vulkan_instance->get_vk_device(), actual->vk_framebuffer_imageless);
+        }
+
+        {
+            std::vector<VkImageView> vk_views = actual->vk_swapchain_views;
+
+            for (auto& vulkan_depth_image : actual->vulkan_depth_images) {
+                vk_views.push_back(vulkan_depth_image->get_vk_view());
+            }
+
+            vulkan_instance->get_framebuffer_cache()->evict_views(vulkan_instance->get_vk_device(), vk_views.data(), vk_views.size());
+        }
+
         vkDestroySwapchainKHR(vulkan_instance->get_vk_device(), actual->vk_swapchain, nullptr);
 
         for (auto vk_view: actual->vk_swapchain_views) {
             vkDestroyImageView(vulkan_instance->get_vk_device(), vk_view, nullptr);
         }
 
-        if (actual->vulkan_depth_image) {
-            actual->vulkan_depth_image->release(vulkan_instance);
+        for (auto& vulkan_depth_image : actual->vulkan_depth_images) {
+            vulkan_depth_image->release(vulkan_instance);
+        }
+    }
+}
+
+void Internal::VulkanWindow::collect_retired_swapchains(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    auto scheduler = vulkan_instance->get_scheduler();
+
+    auto iter = retired_swapchains.begin();
+    while (iter != retired_swapchains.end()) {
+        bool complete = true;
+        for (const auto& point : iter->timeline_points) {
+            if (!scheduler->is_complete(point)) {
+                complete = false;
+                break;
+            }
+        }
+
+        if (complete) {
+            release_swapchain(vulkan_instance, std::move(iter->vulkan_swapchain));
+            iter = retired_swapchains.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
+
+Internal::VulkanCmdPool *Internal::VulkanWindow::get_vulkan_worker_pool(VulkanInstance *vulkan_instance, uint32_t worker) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (vulkan_frames.empty()) {
+        throw std::runtime_error("No frames were allocated! Have you called create_command_objects() yet?");
+    }
+
+    auto& pools = vulkan_frames[frame_slot].vulkan_worker_pools;
+
+    while (pools.size() <= worker) {
+        VulkanCmdPool::PoolConfig config;
+        {
+            config.vk_level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        }
+
+        pools.emplace_back(vulkan_instance->get_queue_graphics()->create_cmd_pool(vulkan_instance->get_vk_device(), config));
+    }
+
+    return pools[worker].get();
+}
+
+Internal::VulkanCmdBuffer *Internal::VulkanWindow::next_vulkan_cmd_buffer_offscreen(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (vulkan_frames.empty()) {
+        throw std::runtime_error("No frames were allocated! Have you called create_command_objects() yet?");
+    }
+
+    VulkanFrame &frame = vulkan_frames[frame_slot];
+    frame.vulkan_cmd_buffer_offscreen = frame.vulkan_cmd_pool->next_cmd_buffer(vulkan_instance->get_vk_device());
+
+    return frame.vulkan_cmd_buffer_offscreen;
+}
+
+Internal::VulkanCmdPool *Internal::VulkanWindow::get_vulkan_compute_pool(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (vulkan_frames.empty()) {
+        throw std::runtime_error("No frames were allocated! Have you called create_command_objects() yet?");
+    }
+
+    auto& pool = vulkan_frames[frame_slot].vulkan_compute_pool;
+
+    if (!pool) {
+        VulkanQueue *vulkan_queue = vulkan_instance->get_queue_compute();
+
+        if (vulkan_queue == nullptr) {
+            throw std::runtime_error("No compute queue was created! Was GPUPreferences::want_compute_queue disabled?");
+        }
+
+        pool = vulkan_queue->create_cmd_pool(vulkan_instance->get_vk_device());
+    }
+
+    return pool.get();
+}
+
+void Internal::VulkanWindow::set_frame_point(const VulkanScheduler::TimelinePoint &point) {
+    if (!point.is_valid()) {
+        return;
+    }
+
+    // Values only ever increase per queue, so the newest point replaces the old one
+    for (auto& existing : vulkan_frames[frame_slot].timeline_points) {
+        if (existing.vulkan_queue == point.vulkan_queue) {
+            existing = point;
+            return;
         }
     }
+
+    vulkan_frames[frame_slot].timeline_points.push_back(point);
 }
 
 VkFramebuffer Internal::VulkanWindow::get_vk_framebuffer(VulkanInstance *vulkan_instance) const {
@@ -379,30 +548,159 @@ VkFramebuffer Internal::VulkanWindow::get_vk_framebuffer(VulkanInstance *vulkan_
         throw std::runtime_error("Swapchain was invalid! Have you created it yet?");
     }
 
-    vkAcquireNextImageKHR(
-        vulkan_instance->get_vk_device(),
-        vulkan_swapchain->vk_swapchain,
-        UINT64_MAX,
-        vk_semaphore_image_ready,
-        nullptr, // TODO: Fence?
-        &vulkan_swapchain->frame_index
-    );
+    if (!image_acquired) {
+        throw std::runtime_error("No swapchain image was acquired! Did acquire_frame() succeed?");
+    }
+
+    if (vulkan_swapchain->dynamic) {
+        return nullptr;
+    }
+
+    if (vulkan_swapchain->vk_framebuffer_imageless != nullptr) {
+        return vulkan_swapchain->vk_framebuffer_imageless;
+    }
+
+    size_t image_count = vulkan_swapchain->vk_swapchain_images.size();
+    return vulkan_swapchain->vk_framebuffers[(frame_slot * image_count) + vulkan_swapchain->frame_index];
+}
+
+bool Internal::VulkanWindow::is_imageless() const {
+    return vulkan_swapchain != nullptr && vulkan_swapchain->vk_framebuffer_imageless != nullptr;
+}
+
+Internal::FixedVector<Internal::VulkanRenderPass::AttachmentBinding, Internal::VulkanRenderPass::MAX_ATTACHMENTS> Internal::VulkanWindow::get_attachments() const {
+    FixedVector<VulkanRenderPass::AttachmentBinding, VulkanRenderPass::MAX_ATTACHMENTS> bindings;
+
+    if (vulkan_swapchain == nullptr) {
+        throw std::runtime_error("Swapchain was invalid! Have you created it yet?");
+    }
+
+    if (!image_acquired) {
+        throw std::runtime_error("No swapchain image was acquired! Did acquire_frame() succeed?");
+    }
+
+    uint32_t image = vulkan_swapchain->frame_index;
+    bindings.push_back({vulkan_swapchain->vk_swapchain_images[image], vulkan_swapchain->vk_swapchain_views[image]});
+
+    if (!vulkan_swapchain->vulkan_depth_images.empty()) {
+        const auto &depth_image = vulkan_swapchain->vulkan_depth_images[frame_slot];
+        bindings.push_back({depth_image->get_vk_image(), depth_image->get_vk_view()});
+    }
 
-    return vulkan_swapchain->vk_framebuffers[vulkan_swapchain->frame_index];
+    return bindings;
 }
 
-void Internal::VulkanWindow::await_frame(VulkanInstance *vulkan_instance) const {
+void Internal::VulkanWindow::await_frame(VulkanInstance *vulkan_instance) {
     if (vulkan_instance == nullptr) {
         throw std::runtime_error("vulkan_instance was nullptr!");
     }
 
-    //vkQueueWaitIdle(vulkan_instance->get_queue_present()->get_vk_queue());
+    if (vulkan_frames.empty()) {
+        throw std::runtime_error("No frames were allocated! Have you called create_command_objects() yet?");
+    }
+
+    // Move onto the next slot, we only block if the GPU hasn't finished the frame that last used it
+    // Slots that were never submitted have an invalid point, which is treated as already complete
+    frame_slot = (frame_slot + 1) % static_cast<uint32_t>(vulkan_frames.size());
+    VulkanFrame &frame = vulkan_frames[frame_slot];
+
+    for (const auto& point : frame.timeline_points) {
+        vulkan_instance->get_scheduler()->wait(point);
+    }
+
+    frame.timeline_points.clear();
+    image_acquired = false;
+
+    // The GPU is done with this slot, so its pools can be reset wholesale and recorded again
+    VkDevice vk_device = vulkan_instance->get_vk_device();
+
+    frame.vulkan_cmd_pool->reset(vk_device);
+
+    frame.vulkan_cmd_buffer = frame.vulkan_cmd_pool->next_cmd_buffer(vk_device);
+    frame.vulkan_cmd_buffer_offscreen = frame.vulkan_cmd_pool->next_cmd_buffer(vk_device);
+
+    for (auto& pool : frame.vulkan_worker_pools) {
+        pool->reset(vk_device);
+    }
+
+    if (frame.vulkan_compute_pool) {
+        frame.vulkan_compute_pool->reset(vk_device);
+    }
 
-    vkWaitForFences(vulkan_instance->get_vk_device(), 1, &vk_fence, VK_TRUE, UINT64_MAX);
-    vkResetFences(vulkan_instance->get_vk_device(), 1, &vk_fence);
+    frame.frame_arena->reset();
+    frame.transient_buffer->reset();
+
+    if (!retired_swapchains.empty()) {
+        collect_retired_swapchains(vulkan_instance);
+    }
 }
 
-void Internal::VulkanWindow::present_frame(Internal::VulkanInstance *vulkan_instance) const {
+Internal::VulkanRenderTarget::AcquireResult Internal::VulkanWindow::acquire_frame(VulkanInstance *vulkan_instance) {
+    if (vulkan_instance == nullptr) {
+        throw std::runtime_error("vulkan_instance was nullptr!");
+    }
+
+    if (!vulkan_swapchain) {
+        throw std::runtime_error("Swapchain was invalid! Have you created it yet?");
+    }
+
+    if (image_acquired) {
+        return AcquireResult::Success;
+    }
+
+    AcquireResult result = try_acquire(vulkan_instance);
+
+    // An out of date swapchain can be replaced and acquired from immediately
+    // We only retry once though, if the surface keeps changing under us it's cheaper to drop the frame
+    if (result == AcquireResult::OutOfDate) {
+        recreate_swapchain(vulkan_instance);
+
+        if (!swapchain_dirty) {
+            result = try_acquire(vulkan_instance);
+        }
+    }
+
+    return result;
+}
+
+Internal::VulkanRenderTarget::AcquireResult Internal::VulkanWindow::try_acquire(VulkanInstance *vulkan_instance) {
+    // A timeout of 0 (or a slow compositor) can return before an image is ready
+    // In that case we skip the frame rather than stalling the caller indefinitely
+    VkResult result = vkAcquireNextImageKHR(
+        vulkan_instance->get_vk_device(),
+        vulkan_swapchain->vk_swapchain,
+        last_config.acquire_timeout,
+        vulkan_frames[frame_slot].vk_semaphore_image_ready,
+        nullptr,
+        &vulkan_swapchain->frame_index
+    );
+
+    switch (result) {
+        case VK_SUCCESS:
+            image_acquired = true;
+            return AcquireResult::Success;
+
+        case VK_SUBOPTIMAL_KHR:
+            // The semaphore is still signaled, so this frame must be presented before recreating
+            image_acquired = true;
+            swapchain_dirty = true;
+            return AcquireResult::Suboptimal;
+
+        case VK_ERROR_OUT_OF_DATE_KHR:
+            swapchain_dirty = true;
+            return AcquireResult::OutOfDate;
+
+        case VK_TIMEOUT:
+        case VK_NOT_READY:
+            return AcquireResult::Timeout;
+
+        default:
+            LOG("vkAcquireNextImageKHR failed with error code (" << string_VkResult(result) << ")");
+            throw std::runtime_error("vkAcquireNextImageKHR failed! Please check the log above for more info!");
+    }
+}
+
+void Internal::VulkanWindow::present_frame(Internal::VulkanInstance *vulkan_instance) {
     if (vulkan_instance == nullptr) {
         throw std::runtime_error("vulkan_instance was nullptr!");
     }
@@ -414,9 +712,15 @@ void Internal::VulkanWindow::present_frame(Internal::VulkanInstance *vulkan_inst
         info.frame_index = vulkan_swapchain->frame_index;
         info.vk_swapchain = vulkan_swapchain->vk_swapchain;
 
-        info.vk_semaphore_work_done = vk_semaphore_work_done;
+        info.vk_semaphore_work_done = vulkan_frames[frame_slot].vk_semaphore_work_done;
     }
 
     //vkQueueWaitIdle(vulkan_instance->get_queue_graphics()->get_vk_queue());
-    vulkan_cmd_buffer->present(info);
+    VkResult result = vulkan_frames[frame_slot].vulkan_cmd_buffer->present(info);
+    image_acquired = false;
+
+    // The image is still consumed on both of these, we just need a new swapchain before the next acquire
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        swapchain_dirty = true;
+    }
 }
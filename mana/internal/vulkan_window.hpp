@@ -34,12 +34,17 @@ SOFTWARE.
 #include <memory>
 
 #include <mana/internal/vulkan_render_target.hpp>
+#include <mana/internal/vulkan_cmd_pool.hpp>
+#include <mana/internal/vulkan_frame_arena.hpp>
+#include <mana/internal/vulkan_transient_buffer.hpp>
+#include <mana/internal/fixed_vector.hpp>
 
 namespace ManaVK::Internal {
     class VulkanInstance;
     class VulkanImage;
     class VulkanQueue;
     class VulkanCmdBuffer;
+    class VulkanRenderPass;
 
     class VulkanWindow : public VulkanRenderTarget {
     public:
@@ -48,9 +53,18 @@ namespace ManaVK::Internal {
             VkColorSpaceKHR vk_color_space;
             VkPresentModeKHR vk_present_mode;
 
-            VkRenderPass vk_render_pass = nullptr;
+            VulkanRenderPass *vulkan_render_pass = nullptr;
 
             std::optional<VkFormat> vk_format_depth;
+
+            // The render pass never loads or stores depth, so it can live in lazily allocated memory
+            bool depth_transient = false;
+
+            // How many frames the CPU can record ahead of the GPU
+            uint32_t frames_in_flight = 2;
+
+            // How long (in nanoseconds) we wait for a swapchain image before skipping the frame
+            uint64_t acquire_timeout = 100000000;
         };
 
         // TODO: Should this not be part of the window?
@@ -60,9 +74,50 @@ namespace ManaVK::Internal {
             VkSwapchainKHR vk_swapchain = nullptr;
             std::vector<VkImage> vk_swapchain_images;
             std::vector<VkImageView> vk_swapchain_views;
+
+            // Indexed by (frame slot * image count) + image index
+            // Each frame slot owns its own depth image, so every slot needs its own set of framebuffers
+            // Owned by the VulkanFramebufferCache, empty when the framebuffer is imageless
             std::vector<VkFramebuffer> vk_framebuffers;
 
-            std::unique_ptr<VulkanImage> vulkan_depth_image;
+            // Serves every image and every frame slot, the views are bound when the pass begins
+            VkFramebuffer vk_framebuffer_imageless = nullptr;
+
+            // Dynamic passes have no framebuffers at all
+            bool dynamic = false;
+
+            std::vector<std::unique_ptr<VulkanImage>> vulkan_depth_images;
+        };
+
+        // A replaced swapchain waiting for the GPU to stop using it
+        // It's freed once every frame that was in flight when it was replaced has completed
+        struct RetiredSwapchain {
+            std::unique_ptr<VulkanSwapchain> vulkan_swapchain;
+            std::vector<VulkanScheduler::TimelinePoint> timeline_points;
+        };
+
+        // Everything a single frame in flight needs to be recorded and submitted independently of the others
+        struct VulkanFrame {
+            // Reset as a whole every time the slot comes around, the buffers below belong to it
+            std::unique_ptr<VulkanCmdPool> vulkan_cmd_pool;
+
+            VulkanCmdBuffer *vulkan_cmd_buffer = nullptr;
+            VulkanCmdBuffer *vulkan_cmd_buffer_offscreen = nullptr;
+
+            // One per recording thread, indexed by worker
+            std::vector<std::unique_ptr<VulkanCmdPool>> vulkan_worker_pools;
+
+            // Created on first use, lives on the compute queue
+            std::unique_ptr<VulkanCmdPool> vulkan_compute_pool;
+
+            std::unique_ptr<VulkanFrameArena> frame_arena;
+            std::unique_ptr<VulkanTransientBuffer> transient_buffer;
+
+            VkSemaphore vk_semaphore_image_ready = nullptr;
+            VkSemaphore vk_semaphore_work_done = nullptr;
+
+            // The last submission this slot made to each queue, the slot is free once all are reached
+            FixedVector<VulkanScheduler::TimelinePoint, 4> timeline_points;
         };
 
     protected:
@@ -71,15 +126,21 @@ namespace ManaVK::Internal {
         VkSurfaceCapabilitiesKHR vk_capabilities;
         VkExtent2D vk_extent;
 
-        VkSemaphore vk_semaphore_image_ready = nullptr;
-        VkSemaphore vk_semaphore_work_done = nullptr;
-        VkFence vk_fence = nullptr;
+        std::vector<VulkanFrame> vulkan_frames;
+        uint32_t frame_slot = 0;
 
-        std::shared_ptr<VulkanCmdBuffer> vulkan_cmd_buffer;
         std::unique_ptr<VulkanSwapchain> vulkan_swapchain;
+        std::vector<RetiredSwapchain> retired_swapchains;
+
+        // Set when acquire or present reports the swapchain no longer matches the surface
+        bool swapchain_dirty = false;
+        bool image_acquired = false;
 
         SwapchainConfig last_config;
 
+        // Single vkAcquireNextImageKHR attempt, acquire_frame() handles recreation
+        AcquireResult try_acquire(VulkanInstance *vulkan_instance);
+
     public:
         VulkanWindow(const std::string& name, int width, int height, bool resizable);
 
@@ -91,6 +152,9 @@ namespace ManaVK::Internal {
 
         void release_swapchain(VulkanInstance *vulkan_instance, std::unique_ptr<VulkanSwapchain> target = nullptr);
 
+        // Frees retired swapchains the GPU is done with, never blocks
+        void collect_retired_swapchains(VulkanInstance *vulkan_instance);
+
     public:
         [[nodiscard]]
         SDL_Window *get_handle() const {
@@ -108,30 +172,71 @@ namespace ManaVK::Internal {
         }
 
         [[nodiscard]]
-        std::shared_ptr<VulkanCmdBuffer> get_vulkan_cmd_buffer() const override {
-           return vulkan_cmd_buffer;
+        bool is_swapchain_dirty() const {
+           return swapchain_dirty;
+        }
+
+        [[nodiscard]]
+        uint32_t get_frame_slot() const {
+           return frame_slot;
         }
 
+        [[nodiscard]]
+        uint32_t get_frames_in_flight() const override {
+           return static_cast<uint32_t>(vulkan_frames.size());
+        }
+
+        [[nodiscard]]
+        VulkanCmdBuffer *get_vulkan_cmd_buffer() const override {
+           return vulkan_frames[frame_slot].vulkan_cmd_buffer;
+        }
+
+        [[nodiscard]]
+        VulkanCmdBuffer *get_vulkan_cmd_buffer_offscreen() const override {
+           return vulkan_frames[frame_slot].vulkan_cmd_buffer_offscreen;
+        }
+
+        VulkanCmdBuffer *next_vulkan_cmd_buffer_offscreen(VulkanInstance *vulkan_instance) override;
+
+        [[nodiscard]]
+        VulkanFrameArena *get_frame_arena() const override {
+           return vulkan_frames[frame_slot].frame_arena.get();
+        }
+
+        [[nodiscard]]
+        VulkanTransientBuffer *get_transient_buffer() const override {
+           return vulkan_frames[frame_slot].transient_buffer.get();
+        }
+
+        VulkanCmdPool *get_vulkan_worker_pool(VulkanInstance *vulkan_instance, uint32_t worker) override;
+
+        VulkanCmdPool *get_vulkan_compute_pool(VulkanInstance *vulkan_instance) override;
+
         VkFramebuffer get_vk_framebuffer(VulkanInstance *vulkan_instance) const override;
 
+        [[nodiscard]]
+        bool is_imageless() const override;
+
+        [[nodiscard]]
+        FixedVector<VulkanRenderPass::AttachmentBinding, VulkanRenderPass::MAX_ATTACHMENTS> get_attachments() const override;
+
         [[nodiscard]]
         VkSemaphore get_vk_semaphore_work_done() const override {
-           return vk_semaphore_work_done;
+           return vulkan_frames[frame_slot].vk_semaphore_work_done;
         }
 
         [[nodiscard]]
         VkSemaphore get_vk_semaphore_image_ready() const override {
-           return vk_semaphore_image_ready;
+           return vulkan_frames[frame_slot].vk_semaphore_image_ready;
         }
 
-        [[nodiscard]]
-        VkFence get_vk_fence() const override {
-           return vk_fence;
-        }
+        void set_frame_point(const VulkanScheduler::TimelinePoint &point) override;
+
+        void await_frame(VulkanInstance *vulkan_instance) override;
 
-        void await_frame(VulkanInstance *vulkan_instance) const override;
+        AcquireResult acquire_frame(VulkanInstance *vulkan_instance) override;
 
-        void present_frame(VulkanInstance *vulkan_instance) const override;
+        void present_frame(VulkanInstance *vulkan_instance) override;
     };
 }
 
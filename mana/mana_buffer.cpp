@@ -0,0 +1,151 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mana_buffer.hpp"
+
+#include <mana/internal/vulkan_buffer.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_upload_engine.hpp>
+
+#include <mana/mana_instance.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace ManaVK;
+
+ManaBuffer::ManaBuffer(ManaInstance *owner, size_t size, ManaBufferUsage usage, ManaMemoryUsage memory_usage)
+    : owner(owner)
+{
+    if (owner == nullptr) {
+        throw std::runtime_error("owner was nullptr!");
+    }
+
+    Internal::VulkanBuffer::BufferSettings settings;
+    {
+        settings.size = size;
+        settings.vk_usage_flags = mana_buffer_usage_to_vk_usage(usage);
+
+        switch (memory_usage) {
+            case ManaMemoryUsage::GPUOnly:
+                settings.memory_usage = Internal::VulkanBuffer::MemoryUsage::GPUOnly;
+                break;
+
+            case ManaMemoryUsage::Stream:
+                settings.memory_usage = Internal::VulkanBuffer::MemoryUsage::Stream;
+                break;
+
+            case ManaMemoryUsage::Readback:
+                settings.memory_usage = Internal::VulkanBuffer::MemoryUsage::Readback;
+                break;
+        }
+    }
+
+    vulkan_buffer = std::make_shared<Internal::VulkanBuffer>(owner->get_vulkan_instance().get(), settings);
+}
+
+ManaBuffer::~ManaBuffer() {
+    release();
+}
+
+void ManaBuffer::write(const void *data, size_t size, size_t offset, std::function<void()> on_complete) {
+    if (vulkan_buffer == nullptr) {
+        throw std::runtime_error("vulkan_buffer was nullptr!");
+    }
+
+    if (offset + size > vulkan_buffer->get_size()) {
+        throw std::runtime_error("Write is out of the buffer's bounds!");
+    }
+
+    if (vulkan_buffer->get_memory_usage() != Internal::VulkanBuffer::MemoryUsage::GPUOnly) {
+        vulkan_buffer->write(data, size, offset);
+
+        if (on_complete) {
+            on_complete();
+        }
+
+        return;
+    }
+
+    Internal::VulkanUploadEngine::BufferUpload upload;
+    {
+        upload.vk_buffer = vulkan_buffer->get_vk_buffer();
+        upload.offset = offset;
+    }
+
+    owner->get_upload_engine()->enqueue_buffer(upload, data, size, Internal::VulkanUploadEngine::Priority::Normal, std::move(on_complete));
+}
+
+void ManaBuffer::flush() {
+    if (vulkan_buffer == nullptr) {
+        throw std::runtime_error("vulkan_buffer was nullptr!");
+    }
+
+    vulkan_buffer->flush(owner->get_vulkan_instance().get());
+}
+
+void ManaBuffer::read(void *data, size_t size, size_t offset) {
+    if (vulkan_buffer == nullptr) {
+        throw std::runtime_error("vulkan_buffer was nullptr!");
+    }
+
+    if (vulkan_buffer->get_memory_usage() != Internal::VulkanBuffer::MemoryUsage::Readback) {
+        throw std::runtime_error("Only Readback buffers can be read!");
+    }
+
+    if (offset + size > vulkan_buffer->get_size()) {
+        throw std::runtime_error("Read is out of the buffer's bounds!");
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+
+    vulkan_buffer->invalidate(vulkan_instance, offset, size);
+    std::memcpy(data, static_cast<uint8_t*>(vulkan_buffer->map(vulkan_instance)) + offset, size);
+}
+
+void ManaBuffer::release() {
+    if (owner == nullptr) {
+        throw std::runtime_error("Owner was nullptr! This object is unable to be released, causing a memory leak!");
+    }
+
+    if (vulkan_buffer != nullptr) {
+        // Uploads that never made it to the GPU would otherwise write into a destroyed buffer
+        owner->get_upload_engine()->cancel_buffer(vulkan_buffer->get_vk_buffer());
+
+        auto func = [vulkan_buffer = vulkan_buffer](ManaInstance* p_instance) {
+            vulkan_buffer->release(p_instance->get_vulkan_instance().get());
+        };
+
+        owner->enqueue_release(func);
+        vulkan_buffer = nullptr;
+    }
+}
+
+size_t ManaBuffer::get_size() const {
+    if (vulkan_buffer == nullptr) {
+        return 0;
+    }
+
+    return vulkan_buffer->get_size();
+}
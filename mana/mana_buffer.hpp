@@ -0,0 +1,78 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_MANA_BUFFER_HPP
+#define MANA_MANA_BUFFER_HPP
+
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+#include <mana/mana_enums.hpp>
+
+namespace ManaVK::Internal {
+    class VulkanBuffer;
+}
+
+namespace ManaVK {
+    class ManaInstance;
+
+    // Vertex, index, uniform and storage data
+    // GPUOnly buffers are filled through the instance's upload engine, the others are written directly
+    class ManaBuffer {
+    protected:
+        ManaInstance *owner;
+        std::shared_ptr<Internal::VulkanBuffer> vulkan_buffer;
+
+    public:
+        ManaBuffer(ManaInstance *owner, size_t size, ManaBufferUsage usage, ManaMemoryUsage memory_usage = ManaMemoryUsage::GPUOnly);
+        ~ManaBuffer();
+
+        // GPUOnly buffers queue an upload, on_complete runs once the GPU can use the data
+        // Host visible buffers are written right away, flush() before the GPU reads them
+        void write(const void *data, size_t size, size_t offset = 0, std::function<void()> on_complete = nullptr);
+
+        // Flushes everything written since the last flush in one go, free on coherent memory
+        void flush();
+
+        // Readback buffers only, make sure the GPU is done writing first
+        void read(void *data, size_t size, size_t offset = 0);
+
+        void release();
+
+    public:
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        std::shared_ptr<Internal::VulkanBuffer> get_vulkan_buffer() const {
+            return vulkan_buffer;
+        }
+
+        [[nodiscard]]
+        size_t get_size() const;
+    };
+}
+
+#endif//MANA_MANA_BUFFER_HPP
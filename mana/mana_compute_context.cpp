@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mana_compute_context.hpp"
+
+#include <mana/mana_instance.hpp>
+#include <mana/mana_render_context.hpp>
+
+#include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_cmd_pool.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_queue.hpp>
+#include <mana/internal/vulkan_render_target.hpp>
+#include <mana/internal/vulkan_transient_buffer.hpp>
+
+#include <stdexcept>
+
+using namespace ManaVK;
+
+ManaComputeContext::ManaComputeContext(Internal::VulkanRenderTarget *vulkan_rt, ManaInstance *owner)
+    : vulkan_rt(vulkan_rt), owner(owner)
+{
+    if (vulkan_rt == nullptr) {
+        throw std::runtime_error("vulkan_rt was nullptr!");
+    }
+
+    if (owner == nullptr) {
+        throw std::runtime_error("owner was nullptr!");
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+    auto pool = vulkan_rt->get_vulkan_compute_pool(vulkan_instance);
+
+    vulkan_cmd_buffer = pool->next_cmd_buffer(vulkan_instance->get_vk_device());
+    vulkan_cmd_buffer->begin(vulkan_instance);
+}
+
+ManaComputeContext::ManaComputeContext(ManaComputeContext &&other) noexcept
+    : vulkan_rt(other.vulkan_rt), owner(other.owner), vulkan_cmd_buffer(other.vulkan_cmd_buffer),
+      timeline_waits(other.timeline_waits), timeline_point(other.timeline_point), submitted(other.submitted)
+{
+    // The moved from context must not submit on destruction
+    other.submitted = true;
+}
+
+ManaComputeContext::~ManaComputeContext() {
+    if (!submitted) {
+        submit();
+    }
+}
+
+void ManaComputeContext::wait_for(const ManaRenderContext &context) {
+    if (submitted) {
+        throw std::runtime_error("Context was already submitted!");
+    }
+
+    Internal::VulkanScheduler::TimelineWait wait;
+    {
+        wait.point = context.get_timeline_point();
+        wait.vk_stage_flags = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+
+    if (wait.point.is_valid()) {
+        timeline_waits.push_back(wait);
+    }
+}
+
+void ManaComputeContext::submit() {
+    if (submitted) {
+        throw std::runtime_error("Context was already submitted!");
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+
+    vulkan_cmd_buffer->end(vulkan_instance);
+    vulkan_rt->get_transient_buffer()->flush(vulkan_instance);
+
+    Internal::VulkanCmdBuffer::SubmitInfo submit_info {};
+    {
+        for (const auto &wait : timeline_waits) {
+            submit_info.timeline_waits.push_back(wait);
+        }
+    }
+
+    timeline_point = vulkan_cmd_buffer->submit(submit_info);
+
+    // The frame slot can't be reused until the compute work is done too
+    vulkan_rt->set_frame_point(timeline_point);
+
+    // Nothing else flushes the compute queue on its own, so get the work started now
+    vulkan_cmd_buffer->get_owner()->flush_submits();
+
+    submitted = true;
+}
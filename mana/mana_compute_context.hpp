@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_COMPUTE_CONTEXT_HPP
+#define MANA_COMPUTE_CONTEXT_HPP
+
+#include <mana/internal/fixed_vector.hpp>
+#include <mana/internal/vulkan_scheduler.hpp>
+
+namespace ManaVK::Internal {
+    class VulkanCmdBuffer;
+    class VulkanRenderTarget;
+}
+
+namespace ManaVK {
+    class ManaInstance;
+    class ManaRenderContext;
+
+    // Records compute work for the current frame onto the compute queue
+    // When the GPU has a dedicated compute family this runs alongside raster work (async compute)
+    // Otherwise it quietly shares the graphics queue, dependencies work the same either way
+    //
+    // Ordering against graphics work is explicit, see wait_for() here and in ManaRenderContext
+    class ManaComputeContext {
+    protected:
+        Internal::VulkanRenderTarget *vulkan_rt = nullptr;
+        ManaInstance *owner = nullptr;
+
+        Internal::VulkanCmdBuffer *vulkan_cmd_buffer = nullptr;
+
+        Internal::FixedVector<Internal::VulkanScheduler::TimelineWait, 4> timeline_waits;
+        Internal::VulkanScheduler::TimelinePoint timeline_point;
+
+        bool submitted = false;
+
+    public:
+        ManaComputeContext(Internal::VulkanRenderTarget *vulkan_rt, ManaInstance *owner);
+        ~ManaComputeContext();
+
+        ManaComputeContext(const ManaComputeContext &) = delete;
+        ManaComputeContext &operator=(const ManaComputeContext &) = delete;
+
+        ManaComputeContext(ManaComputeContext &&other) noexcept;
+
+        // Compute work won't start until the graphics work the context has submitted so far is done
+        // Offscreen work still being recorded isn't included, call ManaRenderContext::submit_offscreen() first
+        void wait_for(const ManaRenderContext &context);
+
+        void submit();
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        Internal::VulkanCmdBuffer *get_vulkan_cmd_buffer() const {
+            return vulkan_cmd_buffer;
+        }
+
+        // Only valid once submitted
+        [[nodiscard]]
+        const Internal::VulkanScheduler::TimelinePoint &get_timeline_point() const {
+            return timeline_point;
+        }
+
+        [[nodiscard]]
+        bool is_submitted() const {
+            return submitted;
+        }
+    };
+}
+
+#endif//MANA_COMPUTE_CONTEXT_HPP
@@ -71,4 +71,31 @@ int ManaVK::mana_samples_to_vk_samples(ManaVK::ManaSamples samples) {
         case ManaSamples::Eight:
             return VK_SAMPLE_COUNT_8_BIT;
     }
-}
\ No newline at end of file
+}
+
+int ManaVK::mana_buffer_usage_to_vk_usage(ManaVK::ManaBufferUsage usage) {
+    int flags = static_cast<int>(usage);
+    int vk_flags = 0;
+
+    if (flags & static_cast<int>(ManaBufferUsage::Vertex)) {
+        vk_flags |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    }
+
+    if (flags & static_cast<int>(ManaBufferUsage::Index)) {
+        vk_flags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    }
+
+    if (flags & static_cast<int>(ManaBufferUsage::Uniform)) {
+        vk_flags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    }
+
+    if (flags & static_cast<int>(ManaBufferUsage::Storage)) {
+        vk_flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    }
+
+    if (flags & static_cast<int>(ManaBufferUsage::Indirect)) {
+        vk_flags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    }
+
+    return vk_flags;
+}
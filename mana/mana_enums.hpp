@@ -46,6 +46,38 @@ namespace ManaVK {
         Presentation
     };
 
+    // How the commands inside a render pass are recorded
+    // Secondary passes are recorded by worker threads, see ManaRenderContext::fork()
+    enum class ManaPassContents {
+        Inline,
+        Secondary
+    };
+
+    // What a ManaBuffer is bound as, these can be combined
+    enum class ManaBufferUsage {
+        Vertex = 1 << 0,
+        Index = 1 << 1,
+        Uniform = 1 << 2,
+        Storage = 1 << 3,
+        Indirect = 1 << 4
+    };
+
+    inline ManaBufferUsage operator|(ManaBufferUsage a, ManaBufferUsage b) {
+        return static_cast<ManaBufferUsage>(static_cast<int>(a) | static_cast<int>(b));
+    }
+
+    // Where a ManaBuffer lives, decides how it can be written
+    enum class ManaMemoryUsage {
+        // Fastest for the GPU, written through background uploads
+        GPUOnly,
+
+        // Rewritten by the CPU often, e.g. per frame uniforms
+        Stream,
+
+        // Filled by the GPU and read by the CPU
+        Readback
+    };
+
     // ManaFormats are a subset of VkFormats
     // The purpose is to hide many options people wouldn't use for a game engine
     // Plus you can more easily validate if a mana format is supported
@@ -83,6 +115,7 @@ namespace ManaVK {
     // This is unsafe! Preferably use ManaInstance::get_vk_depth_format()!
     int mana_depth_format_to_vk_format(ManaDepthFormat format);
     int mana_samples_to_vk_samples(ManaSamples samples);
+    int mana_buffer_usage_to_vk_usage(ManaBufferUsage usage);
 }
 
 #endif//MANA_MANA_ENUMS_HPP
@@ -25,7 +25,11 @@ SOFTWARE.
 #include "mana_instance.hpp"
 
 #include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_pipeline_cache.hpp>
+#include <mana/internal/vulkan_pipeline_compiler.hpp>
+#include <mana/internal/vulkan_pipeline_recorder.hpp>
 #include <mana/internal/vulkan_render_pass.hpp>
+#include <mana/internal/vulkan_upload_engine.hpp>
 
 #include <mana/mana_pipeline.hpp>
 #include <mana/mana_render_pass.hpp>
@@ -35,6 +39,7 @@ SOFTWARE.
 
 #include <SDL.h>
 
+#include <chrono>
 #include <iostream>
 
 using namespace ManaVK;
@@ -203,6 +208,10 @@ ManaInstance::ManaInstance(const ManaVK::ManaInstance::ManaConfig &config) {
         auto requested_extensions = std::vector<Internal::VulkanInstance::VulkanDeviceExtension>();
         {
             requested_extensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME, true);
+
+            if (config.features.dynamic_rendering) {
+                requested_extensions.emplace_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, false);
+            }
         }
 
         {
@@ -249,6 +258,44 @@ ManaInstance::ManaInstance(const ManaVK::ManaInstance::ManaConfig &config) {
         vulkan_instance->init_create_device(device_settings);
     }
 
+    // Pipeline cache loading
+    {
+        pipeline_cache = std::make_shared<Internal::VulkanPipelineCache>(vulkan_instance.get(), config.cache_settings.pipeline_cache_dir);
+
+        if (config.debugging.verbose) {
+            LOG("Pipeline cache '" << pipeline_cache->get_path() << "' (warm = " << std::boolalpha << pipeline_cache->is_warm() << ")");
+        }
+
+        pipeline_compiler = std::make_shared<Internal::VulkanPipelineCompiler>(
+            vulkan_instance.get(),
+            pipeline_cache.get(),
+            config.cache_settings.pipeline_compile_threads
+        );
+
+        // The manifest lives next to the cache, there's nowhere to keep it when the cache is in memory only
+        const auto &cache_settings = config.cache_settings;
+
+        if (!cache_settings.pipeline_cache_dir.empty() && (cache_settings.pipeline_recording || cache_settings.pipeline_warm_up)) {
+            pipeline_recorder = std::make_shared<Internal::VulkanPipelineRecorder>(cache_settings.pipeline_cache_dir + "/mana_pipelines.manifest");
+            pipeline_recording = cache_settings.pipeline_recording;
+
+            if (pipeline_recording) {
+                pipeline_compiler->set_recorder(pipeline_recorder.get());
+            }
+        }
+
+        if (pipeline_recorder != nullptr && cache_settings.pipeline_warm_up) {
+            auto jobs = pipeline_recorder->get_replay_jobs(vulkan_instance->get_vk_device(), vulkan_instance->get_render_pass_cache());
+
+            if (config.debugging.verbose) {
+                LOG("Warming up " << jobs.size() << " pipeline(s) from '" << pipeline_recorder->get_path() << "'");
+            }
+
+            pipeline_warm_up = pipeline_compiler->submit(std::move(jobs));
+            pipeline_warm_up_merge = !pipeline_warm_up.empty();
+        }
+    }
+
     // Presentation initialization
     {
         Internal::VulkanInstance::PresentSettings present_settings;
@@ -359,6 +406,9 @@ ManaInstance::ManaInstance(const ManaVK::ManaInstance::ManaConfig &config) {
             present_settings.vk_present_modes = filtered.found;
         }
 
+        present_settings.frames_in_flight = config.display_settings.frames_in_flight;
+        present_settings.acquire_timeout = static_cast<uint64_t>(config.display_settings.acquire_timeout_ms) * 1000000;
+
         // TODO: High precision / low precision color settings
         // TODO: Expose more defaults
 
@@ -388,6 +438,52 @@ ManaInstance::ManaInstance(const ManaVK::ManaInstance::ManaConfig &config) {
     // Post-bootstrap
     //
     main_window = std::make_shared<ManaWindow>(vulkan_instance->main_window, this);
+
+    {
+        Internal::VulkanUploadEngine::EngineConfig engine_config;
+
+        engine_config.staging_size = static_cast<VkDeviceSize>(config.upload_settings.staging_size_mb) * 1024 * 1024;
+        engine_config.frame_budget = static_cast<VkDeviceSize>(config.upload_settings.frame_budget_mb) * 1024 * 1024;
+
+        upload_engine = std::make_shared<Internal::VulkanUploadEngine>(vulkan_instance.get(), engine_config);
+    }
+}
+
+ManaInstance::~ManaInstance() {
+    // The pipeline's passes queue their releases on us, so it goes while the release queue can still take them
+    // Anyone else still holding the pipeline must let go of it before the instance is destroyed
+    mana_pipeline = nullptr;
+
+    // Whatever the workers compiled ends up in the main cache before it's saved
+    if (pipeline_compiler != nullptr) {
+        pipeline_compiler->release(pipeline_cache.get());
+    }
+
+    if (pipeline_recorder != nullptr && pipeline_recording) {
+        pipeline_recorder->save();
+    }
+
+    if (pipeline_cache != nullptr) {
+        pipeline_cache->save(vulkan_instance.get());
+        pipeline_cache->release(vulkan_instance.get());
+    }
+
+    // Releases still deferred would otherwise leak, nothing can be in flight once the device is idle
+    VkResult result = vkDeviceWaitIdle(vulkan_instance->get_vk_device());
+
+    if (result != VK_SUCCESS) {
+        LOG("vkDeviceWaitIdle failed with error code (" << string_VkResult(result) << ")");
+    }
+
+    release_queue.release_all(this);
+
+    // After the release queue, deferred pass releases still evict from the framebuffer cache
+    vulkan_instance->release_caches();
+
+    // Uploads still pending are dropped, their destinations are gone by now anyway
+    if (upload_engine != nullptr) {
+        upload_engine->release(vulkan_instance.get());
+    }
 }
 
 //
@@ -396,15 +492,22 @@ ManaInstance::ManaInstance(const ManaVK::ManaInstance::ManaConfig &config) {
 void ManaInstance::flush() {
     main_window->flush(this);
 
-    for (auto& func : release_queue) {
-        func(this);
-    }
+    upload_engine->process(vulkan_instance.get());
 
-    release_queue.clear();
-}
+    release_queue.flush(this);
+
+    // The warm-up only went into the workers' caches, direct builds (and the other workers) miss it until it's merged
+    // Checked from the back, low priority jobs are mostly picked in order so the back tends to finish last
+    if (pipeline_warm_up_merge) {
+        while (!pipeline_warm_up.empty() && pipeline_warm_up.back().wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            pipeline_warm_up.pop_back();
+        }
 
-void ManaInstance::enqueue_release(const std::function<void(ManaInstance *)> &func) {
-    release_queue.emplace_back(func);
+        // Waiting on in flight jobs would stall the frame, an idle compiler only leaves the merge itself
+        if (pipeline_warm_up.empty() && pipeline_compiler->try_merge(pipeline_cache.get(), true)) {
+            pipeline_warm_up_merge = false;
+        }
+    }
 }
 
 //
@@ -449,7 +552,8 @@ int ManaInstance::get_vk_depth_format(ManaVK::ManaDepthFormat format) const {
 // Helpers
 //
 uint32_t ManaInstance::get_api_version(const ManaVK::ManaInstance::ManaFeatures &features) const {
-    uint32_t version = VK_API_VERSION_1_0;
+    // Timeline semaphores are core in 1.2, we rely on them for frame scheduling
+    uint32_t version = VK_API_VERSION_1_2;
 
     if (features.raytracing) {
         // TODO: Use a lower API version?
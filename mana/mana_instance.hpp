@@ -25,17 +25,24 @@ SOFTWARE.
 #ifndef MANA_MANA_INSTANCE_HPP
 #define MANA_MANA_INSTANCE_HPP
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
-#include <functional>
+#include <utility>
 
 #include <mana/mana_enums.hpp>
+#include <mana/mana_release_queue.hpp>
 
 typedef union SDL_Event SDL_Event;
 
 namespace ManaVK::Internal {
     class VulkanInstance;
+    class VulkanUploadEngine;
+    class VulkanPipeline;
+    class VulkanPipelineCache;
+    class VulkanPipelineCompiler;
+    class VulkanPipelineRecorder;
 }
 
 namespace ManaVK::Builders {
@@ -57,6 +64,9 @@ namespace ManaVK {
 
             // TODO: Implement raytracing
             bool raytracing = false;
+
+            // Optional, render graph passes skip VkRenderPass / VkFramebuffer objects when the device supports it
+            bool dynamic_rendering = true;
         };
 
         struct ManaDebugging {
@@ -89,6 +99,34 @@ namespace ManaVK {
             bool vsync = true;
             bool srgb = false;
             bool precise_depth = true;
+
+            // How many frames the CPU can record ahead of the GPU, 1 means the CPU always waits for the GPU
+            uint32_t frames_in_flight = 2;
+
+            // How long (in milliseconds) a frame waits for a window image before it is skipped
+            uint32_t acquire_timeout_ms = 100;
+        };
+
+        struct ManaUploadSettings {
+            // Size of the staging ring used to stream data to the GPU, no single image may be larger
+            uint32_t staging_size_mb = 64;
+
+            // How much data is sent to the GPU each flush()
+            uint32_t frame_budget_mb = 8;
+        };
+
+        struct ManaCacheSettings {
+            // Where compiled pipelines are kept between runs, empty keeps them in memory only
+            std::string pipeline_cache_dir = ".";
+
+            // Threads compiling pipelines in the background, 0 uses every core but one
+            uint32_t pipeline_compile_threads = 0;
+
+            // Adds every pipeline built to a manifest next to the pipeline cache, saved on shutdown
+            bool pipeline_recording = false;
+
+            // Compiles everything in the manifest on the pipeline compiler at startup, at low priority
+            bool pipeline_warm_up = true;
         };
 
         struct ManaConfig {
@@ -96,6 +134,8 @@ namespace ManaVK {
             ManaDebugging debugging;
             ManaWindowSettings window_settings;
             ManaDisplaySettings display_settings;
+            ManaUploadSettings upload_settings;
+            ManaCacheSettings cache_settings;
 
             std::shared_ptr<ManaPipeline> mana_pipeline;
 
@@ -110,11 +150,22 @@ namespace ManaVK {
         std::shared_ptr<ManaPipeline> mana_pipeline;
 
         std::shared_ptr<Internal::VulkanInstance> vulkan_instance = nullptr;
+        std::shared_ptr<Internal::VulkanUploadEngine> upload_engine = nullptr;
+        std::shared_ptr<Internal::VulkanPipelineCache> pipeline_cache = nullptr;
+        std::shared_ptr<Internal::VulkanPipelineCompiler> pipeline_compiler = nullptr;
+        std::shared_ptr<Internal::VulkanPipelineRecorder> pipeline_recorder = nullptr;
+        bool pipeline_recording = false;
+
+        // VulkanPipelineCompiler::Handles of the startup warm-up, flush() merges the caches once they're all ready
+        std::vector<std::shared_future<std::shared_ptr<Internal::VulkanPipeline>>> pipeline_warm_up;
+
+        // Set while the finished warm-up still has to be merged, flush() retries until the compiler is idle
+        bool pipeline_warm_up_merge = false;
 
         std::shared_ptr<ManaWindow> main_window = nullptr;
         std::vector<std::shared_ptr<ManaWindow>> child_windows;
 
-        std::vector<std::function<void(ManaInstance*)>> release_queue;
+        ManaReleaseQueue release_queue;
 
         int vk_format_default_color;
         int vk_format_default_depth;
@@ -123,18 +174,26 @@ namespace ManaVK {
         // Bootstraps the user through initial setup without the user having to touch Vulkan once!
         ManaInstance(const ManaConfig& config);
 
+        // Stops the pipeline compiler and saves the pipeline cache (and manifest), so the next run starts warm
+        ~ManaInstance();
+
         //
         // Methods
         //
 
         // Usually called before any rendering is done
         // This will process the release queue
-        // But will also process the transfer queue
+        // But will also process the transfer queue, sending this frame's share of pending uploads
+        // Once the pipeline warm-up has finished, it's merged into the main pipeline cache here
+        // The merge never waits on the compiler, it's put off until no other jobs are queued or compiling
         void flush();
 
-
-        // Queues a release function
-        void enqueue_release(const std::function<void(ManaInstance*)> &func);
+        // Queues a release function, run once the GPU is done with everything submitted before the next flush()
+        // Safe to call from any thread
+        template<typename F>
+        void enqueue_release(F &&func) {
+            release_queue.push(ManaReleaseFunc(std::forward<F>(func)));
+        }
 
         //
         // SDL / ImGui
@@ -150,11 +209,38 @@ namespace ManaVK {
             return main_window;
         }
 
+        // Returned by reference, copying the shared_ptr costs two atomics every call on the frame path
         [[nodiscard]]
-        std::shared_ptr<Internal::VulkanInstance> get_vulkan_instance() const {
+        const std::shared_ptr<Internal::VulkanInstance> &get_vulkan_instance() const {
             return vulkan_instance;
         }
 
+        // Streams buffer and image data to the GPU in the background, see VulkanUploadEngine
+        [[nodiscard]]
+        Internal::VulkanUploadEngine *get_upload_engine() const {
+            return upload_engine.get();
+        }
+
+        // Pass to VulkanPipelineBuilder::build_graphics() / build_compute(), ready before ManaPipeline::initialize()
+        // Pipelines built on the compiler only reach it once merged, flush() does so for the startup warm-up
+        // Anything else relying on it calls get_pipeline_compiler()->merge(get_pipeline_cache()) first
+        [[nodiscard]]
+        Internal::VulkanPipelineCache *get_pipeline_cache() const {
+            return pipeline_cache.get();
+        }
+
+        // Builds batches of pipelines on worker threads, see VulkanPipelineCompiler
+        [[nodiscard]]
+        Internal::VulkanPipelineCompiler *get_pipeline_compiler() const {
+            return pipeline_compiler.get();
+        }
+
+        // Null unless ManaCacheSettings::pipeline_recording is set, pass to VulkanPipelineBuilder::build_graphics() / build_compute()
+        [[nodiscard]]
+        Internal::VulkanPipelineRecorder *get_pipeline_recorder() const {
+            return pipeline_recording ? pipeline_recorder.get() : nullptr;
+        }
+
         int get_vk_color_format(ManaColorFormat format) const;
         int get_vk_depth_format(ManaDepthFormat format) const;
 
@@ -0,0 +1,207 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mana_release_queue.hpp"
+
+#include <mana/mana_instance.hpp>
+
+#include <mana/internal/vulkan_instance.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+
+using namespace ManaVK;
+
+static_assert((ManaReleaseQueue::RING_CAPACITY & (ManaReleaseQueue::RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two!");
+
+//
+// ManaReleaseFunc
+//
+ManaReleaseFunc::ManaReleaseFunc(ManaReleaseFunc &&other) noexcept {
+    if (other.ops != nullptr) {
+        other.ops->move(storage, other.storage);
+        ops = other.ops;
+        other.ops = nullptr;
+    }
+}
+
+ManaReleaseFunc &ManaReleaseFunc::operator=(ManaReleaseFunc &&other) noexcept {
+    if (this != &other) {
+        if (ops != nullptr) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+
+        if (other.ops != nullptr) {
+            other.ops->move(storage, other.storage);
+            ops = other.ops;
+            other.ops = nullptr;
+        }
+    }
+
+    return *this;
+}
+
+ManaReleaseFunc::~ManaReleaseFunc() {
+    if (ops != nullptr) {
+        ops->destroy(storage);
+    }
+}
+
+void ManaReleaseFunc::operator()(ManaInstance *mana_instance) {
+    if (ops == nullptr) {
+        throw std::runtime_error("Attempted to invoke an empty ManaReleaseFunc!");
+    }
+
+    ops->invoke(storage, mana_instance);
+}
+
+//
+// ManaReleaseQueue
+//
+ManaReleaseQueue::ManaReleaseQueue() {
+    cells = std::make_unique<Cell[]>(RING_CAPACITY);
+
+    for (size_t c = 0; c < RING_CAPACITY; c++) {
+        cells[c].sequence.store(c, std::memory_order_relaxed);
+    }
+}
+
+void ManaReleaseQueue::push(ManaReleaseFunc &&func) {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+
+    while (true) {
+        cell = &cells[pos & (RING_CAPACITY - 1)];
+
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            // The cell is free, try to claim it
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer hasn't caught up, the ring is full
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+
+            overflow.emplace_back(std::move(func));
+            has_overflow.store(true, std::memory_order_release);
+            return;
+        } else {
+            // Another producer claimed this cell first
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->func = std::move(func);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void ManaReleaseQueue::drain(Batch &batch) {
+    while (true) {
+        Cell &cell = cells[dequeue_pos & (RING_CAPACITY - 1)];
+
+        // Either empty or a producer is still writing into it, whatever is left is picked up next flush
+        if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+            break;
+        }
+
+        batch.funcs.emplace_back(std::move(cell.func));
+        cell.sequence.store(dequeue_pos + RING_CAPACITY, std::memory_order_release);
+
+        dequeue_pos++;
+    }
+
+    if (has_overflow.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(overflow_mutex);
+
+        for (auto& func : overflow) {
+            batch.funcs.emplace_back(std::move(func));
+        }
+
+        overflow.clear();
+        has_overflow.store(false, std::memory_order_relaxed);
+    }
+}
+
+void ManaReleaseQueue::run(Batch &batch, ManaInstance *mana_instance) {
+    for (auto& func : batch.funcs) {
+        func(mana_instance);
+    }
+}
+
+void ManaReleaseQueue::flush(ManaInstance *mana_instance) {
+    if (mana_instance == nullptr) {
+        throw std::runtime_error("mana_instance was nullptr!");
+    }
+
+    auto scheduler = mana_instance->get_vulkan_instance()->get_scheduler();
+
+    Batch batch;
+    drain(batch);
+
+    if (!batch.funcs.empty()) {
+        batch.timeline_points = scheduler->get_submitted_points();
+        batches.emplace_back(std::move(batch));
+    }
+
+    // Batches are tagged in submission order, so the first incomplete one blocks the rest
+    while (!batches.empty()) {
+        Batch &front = batches.front();
+
+        for (const auto& point : front.timeline_points) {
+            if (!scheduler->is_complete(point)) {
+                return;
+            }
+        }
+
+        run(front, mana_instance);
+        batches.pop_front();
+    }
+}
+
+void ManaReleaseQueue::release_all(ManaInstance *mana_instance) {
+    if (mana_instance == nullptr) {
+        throw std::runtime_error("mana_instance was nullptr!");
+    }
+
+    auto scheduler = mana_instance->get_vulkan_instance()->get_scheduler();
+
+    Batch batch;
+    drain(batch);
+
+    batch.timeline_points = scheduler->get_submitted_points();
+    batches.emplace_back(std::move(batch));
+
+    while (!batches.empty()) {
+        Batch &front = batches.front();
+
+        scheduler->wait_all(front.timeline_points);
+        run(front, mana_instance);
+
+        batches.pop_front();
+    }
+}
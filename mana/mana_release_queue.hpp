@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_MANA_RELEASE_QUEUE_HPP
+#define MANA_MANA_RELEASE_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mana/internal/vulkan_scheduler.hpp>
+
+namespace ManaVK {
+    class ManaInstance;
+
+    // A move-only void(ManaInstance*) callable that keeps small captures inline
+    // Most releases only capture a handle or a shared_ptr, so this avoids a heap allocation per release
+    class ManaReleaseFunc {
+    public:
+        static constexpr size_t INLINE_SIZE = 48;
+
+    protected:
+        struct Ops {
+            void (*invoke)(void *storage, ManaInstance *mana_instance);
+            void (*move)(void *dst, void *src);
+            void (*destroy)(void *storage);
+        };
+
+        template<typename F>
+        static constexpr bool fits_inline = sizeof(F) <= INLINE_SIZE
+            && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<F>;
+
+        template<typename F>
+        static const Ops *get_inline_ops() {
+            static const Ops ops = {
+                [](void *storage, ManaInstance *mana_instance) {
+                    (*std::launder(reinterpret_cast<F*>(storage)))(mana_instance);
+                },
+                [](void *dst, void *src) {
+                    F *func = std::launder(reinterpret_cast<F*>(src));
+                    new (dst) F(std::move(*func));
+                    func->~F();
+                },
+                [](void *storage) {
+                    std::launder(reinterpret_cast<F*>(storage))->~F();
+                }
+            };
+
+            return &ops;
+        }
+
+        // Oversized callables are boxed, only the pointer lives inline
+        template<typename F>
+        static const Ops *get_heap_ops() {
+            static const Ops ops = {
+                [](void *storage, ManaInstance *mana_instance) {
+                    (**reinterpret_cast<F**>(storage))(mana_instance);
+                },
+                [](void *dst, void *src) {
+                    *reinterpret_cast<F**>(dst) = *reinterpret_cast<F**>(src);
+                },
+                [](void *storage) {
+                    delete *reinterpret_cast<F**>(storage);
+                }
+            };
+
+            return &ops;
+        }
+
+        alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+        const Ops *ops = nullptr;
+
+    public:
+        ManaReleaseFunc() = default;
+
+        template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, ManaReleaseFunc>>>
+        ManaReleaseFunc(F &&func) {
+            using Func = std::decay_t<F>;
+
+            if constexpr (fits_inline<Func>) {
+                new (storage) Func(std::forward<F>(func));
+                ops = get_inline_ops<Func>();
+            } else {
+                *reinterpret_cast<Func**>(storage) = new Func(std::forward<F>(func));
+                ops = get_heap_ops<Func>();
+            }
+        }
+
+        ManaReleaseFunc(ManaReleaseFunc &&other) noexcept;
+        ManaReleaseFunc &operator=(ManaReleaseFunc &&other) noexcept;
+
+        ManaReleaseFunc(const ManaReleaseFunc &) = delete;
+        ManaReleaseFunc &operator=(const ManaReleaseFunc &) = delete;
+
+        ~ManaReleaseFunc();
+
+        void operator()(ManaInstance *mana_instance);
+
+        explicit operator bool() const {
+            return ops != nullptr;
+        }
+    };
+
+    // Defers releasing resources until the GPU is done with every submission that could reference them
+    //
+    // Any thread may push, pushes go into a lock-free bounded ring (Vyukov style MPSC)
+    // If the ring is ever full we fall back to a mutex guarded overflow list rather than blocking the producer
+    //
+    // Only the owning thread may flush, which tags everything pushed so far with the submitted point of every queue
+    // A batch is run once all of its points have completed, so flush must happen between frames (after submission)
+    class ManaReleaseQueue {
+    public:
+        // Must be a power of two
+        static constexpr size_t RING_CAPACITY = 1024;
+
+    protected:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            ManaReleaseFunc func;
+        };
+
+        struct Batch {
+            std::vector<Internal::VulkanScheduler::TimelinePoint> timeline_points;
+            std::vector<ManaReleaseFunc> funcs;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+
+        // Producers and the consumer get their own cache lines
+        alignas(64) std::atomic<size_t> enqueue_pos {0};
+        alignas(64) size_t dequeue_pos = 0;
+
+        std::mutex overflow_mutex;
+        std::vector<ManaReleaseFunc> overflow;
+        std::atomic<bool> has_overflow {false};
+
+        std::deque<Batch> batches;
+
+        // Moves everything pushed so far into a new untagged batch
+        void drain(Batch &batch);
+
+        void run(Batch &batch, ManaInstance *mana_instance);
+
+    public:
+        ManaReleaseQueue();
+
+        ManaReleaseQueue(const ManaReleaseQueue &) = delete;
+        ManaReleaseQueue &operator=(const ManaReleaseQueue &) = delete;
+
+        // Safe to call from any thread
+        void push(ManaReleaseFunc &&func);
+
+        // Tags pending releases and runs the batches the GPU has finished with, never blocks
+        void flush(ManaInstance *mana_instance);
+
+        // Waits for the GPU and runs everything, used when tearing down
+        void release_all(ManaInstance *mana_instance);
+
+        [[nodiscard]]
+        size_t get_batch_count() const {
+            return batches.size();
+        }
+    };
+}
+
+#endif//MANA_MANA_RELEASE_QUEUE_HPP
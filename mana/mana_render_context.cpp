@@ -27,14 +27,21 @@ SOFTWARE.
 #include <mana/mana_instance.hpp>
 
 #include <mana/internal/vulkan_cmd_buffer.hpp>
+#include <mana/internal/vulkan_cmd_pool.hpp>
+#include <mana/internal/vulkan_frame_arena.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_queue.hpp>
+#include <mana/internal/vulkan_render_pass.hpp>
 #include <mana/internal/vulkan_render_target.hpp>
+#include <mana/internal/vulkan_transient_buffer.hpp>
 
+#include <cstring>
 #include <stdexcept>
 
 using namespace ManaVK;
 
-ManaRenderContext::ManaRenderContext(Internal::VulkanRenderTarget *vulkan_rt, ManaInstance *owner)
-    : vulkan_rt(vulkan_rt), owner(owner)
+ManaRenderContext::ManaRenderContext(Internal::VulkanRenderTarget *vulkan_rt, ManaInstance *owner, bool skipped)
+    : vulkan_rt(vulkan_rt), owner(owner), skipped(skipped)
 {
     if (vulkan_rt == nullptr) {
         throw std::runtime_error("vulkan_rt was nullptr!");
@@ -43,11 +50,6 @@ ManaRenderContext::ManaRenderContext(Internal::VulkanRenderTarget *vulkan_rt, Ma
     if (owner == nullptr) {
         throw std::runtime_error("owner was nullptr!");
     }
-
-    auto vulkan_instance = owner->get_vulkan_instance();
-    auto cmd_buffer = vulkan_rt->get_vulkan_cmd_buffer();
-
-    cmd_buffer->begin(vulkan_instance.get());
 }
 
 ManaRenderContext::~ManaRenderContext() {
@@ -56,6 +58,239 @@ ManaRenderContext::~ManaRenderContext() {
     }
 }
 
+void ManaRenderContext::submit_offscreen() {
+    if (!offscreen_recording) {
+        return;
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+    auto cmd_buffer = vulkan_rt->get_vulkan_cmd_buffer_offscreen();
+
+    cmd_buffer->end(vulkan_instance);
+    vulkan_rt->get_transient_buffer()->flush(vulkan_instance);
+
+    // Nothing offscreen touches the target, so there's nothing but other queues to wait on
+    // Target work is submitted later to the same queue, so it still runs after this
+    Internal::VulkanCmdBuffer::SubmitInfo submit_info {};
+    {
+        for (const auto &wait : timeline_waits) {
+            submit_info.timeline_waits.push_back(wait);
+        }
+    }
+
+    timeline_point = cmd_buffer->submit(submit_info);
+    vulkan_rt->set_frame_point(timeline_point);
+
+    offscreen_recording = false;
+    offscreen_submitted = true;
+}
+
+ManaComputeContext ManaRenderContext::begin_compute() {
+    return ManaComputeContext(vulkan_rt, owner);
+}
+
+void ManaRenderContext::wait_for(ManaComputeContext &compute) {
+    if (submitted) {
+        throw std::runtime_error("Context was already submitted!");
+    }
+
+    if (!compute.is_submitted()) {
+        compute.submit();
+    }
+
+    // Work already recorded into the offscreen buffer gets the wait too, it hasn't been submitted yet
+    Internal::VulkanScheduler::TimelineWait wait;
+    {
+        wait.point = compute.get_timeline_point();
+        wait.vk_stage_flags = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+
+    timeline_waits.push_back(wait);
+}
+
+bool ManaRenderContext::acquire() {
+    if (acquired) {
+        return true;
+    }
+
+    if (submitted) {
+        throw std::runtime_error("Context was already submitted!");
+    }
+
+    acquire_attempted = true;
+
+    // Get the offscreen work onto the GPU before we potentially wait on the presentation engine
+    submit_offscreen();
+    vulkan_rt->get_vulkan_cmd_buffer_offscreen()->get_owner()->flush_submits();
+
+    if (skipped) {
+        return false;
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+
+    using AcquireResult = Internal::VulkanRenderTarget::AcquireResult;
+    AcquireResult result = vulkan_rt->acquire_frame(vulkan_instance);
+
+    if (result != AcquireResult::Success && result != AcquireResult::Suboptimal) {
+        skipped = true;
+        return false;
+    }
+
+    vulkan_rt->get_vulkan_cmd_buffer()->begin(vulkan_instance);
+
+    acquired = true;
+    return true;
+}
+
+ManaTransientAllocation ManaRenderContext::allocate_transient(size_t size, size_t alignment) {
+    if (submitted) {
+        throw std::runtime_error("Context was already submitted!");
+    }
+
+    auto transient = vulkan_rt->get_transient_buffer()->allocate(owner->get_vulkan_instance().get(), size, alignment);
+
+    ManaTransientAllocation allocation;
+    {
+        allocation.vulkan_buffer = transient.vulkan_buffer;
+        allocation.offset = transient.offset;
+        allocation.size = transient.size;
+        allocation.data = transient.data;
+    }
+
+    return allocation;
+}
+
+ManaTransientAllocation ManaRenderContext::push_transient(const void *data, size_t size) {
+    ManaTransientAllocation allocation = allocate_transient(size);
+    std::memcpy(allocation.data, data, size);
+
+    return allocation;
+}
+
+Internal::VulkanCmdBuffer *ManaRenderContext::get_active_cmd_buffer() {
+    if (submitted) {
+        throw std::runtime_error("Context was already submitted!");
+    }
+
+    if (acquired) {
+        return vulkan_rt->get_vulkan_cmd_buffer();
+    }
+
+    if (is_dropped()) {
+        return nullptr;
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+    auto cmd_buffer = vulkan_rt->get_vulkan_cmd_buffer_offscreen();
+
+    if (!offscreen_recording) {
+        // The previous buffer is still pending, it can't be begun again until its frame slot comes around
+        if (offscreen_submitted) {
+            cmd_buffer = vulkan_rt->next_vulkan_cmd_buffer_offscreen(vulkan_instance);
+            offscreen_submitted = false;
+        }
+
+        cmd_buffer->begin(vulkan_instance);
+        offscreen_recording = true;
+    }
+
+    return cmd_buffer;
+}
+
+ManaWorkerList ManaRenderContext::fork(uint32_t count) {
+    if (is_dropped()) {
+        return ManaWorkerList();
+    }
+
+    if (active_pass == nullptr) {
+        throw std::runtime_error("Can't fork outside of a render pass!");
+    }
+
+    if (active_contents != ManaPassContents::Secondary) {
+        throw std::runtime_error("Can't fork a pass that wasn't begun with ManaPassContents::Secondary!");
+    }
+
+    if (forked) {
+        throw std::runtime_error("Context was already forked! Join the previous workers first!");
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+
+    Internal::VulkanCmdBuffer::InheritanceInfo inheritance {};
+    if (active_pass->is_dynamic()) {
+        inheritance.dynamic = true;
+
+        for (uint32_t a = 0; a < active_pass->get_attachment_count(); a++) {
+            const auto &attachment = active_pass->get_attachment(a);
+            inheritance.vk_samples = attachment.vk_samples;
+
+            if (!active_pass->has_depth() || a != active_pass->get_attachment_count() - 1) {
+                inheritance.vk_color_formats.push_back(attachment.vk_format);
+                continue;
+            }
+
+            inheritance.vk_depth_format = attachment.vk_format;
+
+            if (Internal::VulkanRenderPass::has_stencil(attachment.vk_format)) {
+                inheritance.vk_stencil_format = attachment.vk_format;
+            }
+        }
+    } else {
+        inheritance.vk_render_pass = active_pass->get_vk_render_pass();
+        inheritance.subpass = 0;
+        inheritance.vk_framebuffer = vulkan_rt->get_vk_framebuffer(vulkan_instance);
+    }
+
+    ManaWorkerContext *workers = vulkan_rt->get_frame_arena()->allocate<ManaWorkerContext>(count);
+
+    // Beginning here keeps the pools single threaded, workers only ever record
+    for (uint32_t w = 0; w < count; w++) {
+        auto pool = vulkan_rt->get_vulkan_worker_pool(vulkan_instance, w);
+        auto cmd_buffer = pool->next_cmd_buffer(vulkan_instance->get_vk_device());
+
+        cmd_buffer->begin(vulkan_instance, &inheritance);
+        workers[w] = ManaWorkerContext(cmd_buffer, w);
+    }
+
+    forked = true;
+    return ManaWorkerList(workers, count);
+}
+
+void ManaRenderContext::join(const ManaWorkerList &workers) {
+    if (is_dropped() && !forked) {
+        return;
+    }
+
+    if (!forked) {
+        throw std::runtime_error("Context wasn't forked!");
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+
+    VkCommandBuffer *vk_cmd_buffers = vulkan_rt->get_frame_arena()->allocate<VkCommandBuffer>(workers.size());
+
+    for (uint32_t w = 0; w < workers.size(); w++) {
+        workers[w].get_vulkan_cmd_buffer()->end(vulkan_instance);
+        vk_cmd_buffers[w] = workers[w].get_vulkan_cmd_buffer()->get_vk_cmd_buffer();
+    }
+
+    if (workers.size() > 0) {
+        vkCmdExecuteCommands(get_active_cmd_buffer()->get_vk_cmd_buffer(), workers.size(), vk_cmd_buffers);
+    }
+
+    forked = false;
+}
+
+void ManaRenderContext::set_active_pass(Internal::VulkanRenderPass *vulkan_render_pass, ManaPassContents contents) {
+    if (vulkan_render_pass == nullptr && forked) {
+        throw std::runtime_error("Render pass ended while forked! Join the workers before ending the pass!");
+    }
+
+    active_pass = vulkan_render_pass;
+    active_contents = contents;
+}
+
 void ManaRenderContext::submit() {
     if (vulkan_rt == nullptr) {
         throw std::runtime_error("vulkan_rt was nullptr!");
@@ -65,22 +300,37 @@ void ManaRenderContext::submit() {
         throw std::runtime_error("owner was nullptr!");
     }
 
-    auto vulkan_instance = owner->get_vulkan_instance();
+    // Offscreen work recorded without ever acquiring still runs, a skipped acquire already sent what was recorded
+    submit_offscreen();
+
+    // Nothing drew to the target, so there's nothing to present either
+    // Presenting would have flushed the queue for us, so we have to do it ourselves
+    if (!acquired) {
+        vulkan_rt->get_vulkan_cmd_buffer_offscreen()->get_owner()->flush_submits();
+        submitted = true;
+        return;
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
     auto cmd_buffer = vulkan_rt->get_vulkan_cmd_buffer();
 
-    cmd_buffer->end(vulkan_instance.get());
+    cmd_buffer->end(vulkan_instance);
+    vulkan_rt->get_transient_buffer()->flush(vulkan_instance);
 
     Internal::VulkanCmdBuffer::SubmitInfo submit_info {};
     {
-        submit_info.vk_fence = vulkan_rt->get_vk_fence();
-
         submit_info.vk_wait_semaphores.push_back(vulkan_rt->get_vk_semaphore_image_ready());
         
         submit_info.vk_signal_semaphores.push_back(vulkan_rt->get_vk_semaphore_work_done());
+
+        for (const auto &wait : timeline_waits) {
+            submit_info.timeline_waits.push_back(wait);
+        }
     }
 
-    cmd_buffer->submit(submit_info);
-    vulkan_rt->present_frame(vulkan_instance.get());
+    timeline_point = cmd_buffer->submit(submit_info);
+    vulkan_rt->set_frame_point(timeline_point);
+    vulkan_rt->present_frame(vulkan_instance);
 
     submitted = true;
 }
@@ -26,29 +26,165 @@ SOFTWARE.
 #define MANA_RENDER_CONTEXT_HPP
 
 #include <mana/mana_enums.hpp>
+#include <mana/mana_compute_context.hpp>
+
+#include <mana/internal/fixed_vector.hpp>
+#include <mana/internal/vulkan_scheduler.hpp>
+
+#include <cstddef>
+#include <cstdint>
 
 namespace ManaVK::Internal {
+    class VulkanBuffer;
+    class VulkanCmdBuffer;
+    class VulkanRenderPass;
     class VulkanRenderTarget;
 }
 
 namespace ManaVK {
     class ManaInstance;
 
+    // A slice of a render pass recorded on another thread, see ManaRenderContext::fork()
+    // Only the thread it was handed to may record into it until it is joined
+    class ManaWorkerContext {
+    protected:
+        Internal::VulkanCmdBuffer *vulkan_cmd_buffer = nullptr;
+        uint32_t worker = 0;
+
+    public:
+        ManaWorkerContext() = default;
+        ManaWorkerContext(Internal::VulkanCmdBuffer *vulkan_cmd_buffer, uint32_t worker)
+            : vulkan_cmd_buffer(vulkan_cmd_buffer), worker(worker) {}
+
+        //
+        // Getters
+        //
+        [[nodiscard]]
+        Internal::VulkanCmdBuffer *get_vulkan_cmd_buffer() const {
+            return vulkan_cmd_buffer;
+        }
+
+        [[nodiscard]]
+        uint32_t get_worker() const {
+            return worker;
+        }
+    };
+
+    // The workers returned by ManaRenderContext::fork(), the storage belongs to the frame and is gone next frame
+    class ManaWorkerList {
+    protected:
+        ManaWorkerContext *workers = nullptr;
+        uint32_t count = 0;
+
+    public:
+        ManaWorkerList() = default;
+        ManaWorkerList(ManaWorkerContext *workers, uint32_t count)
+            : workers(workers), count(count) {}
+
+        ManaWorkerContext &operator[](uint32_t index) const {
+            return workers[index];
+        }
+
+        ManaWorkerContext *begin() const {
+            return workers;
+        }
+
+        ManaWorkerContext *end() const {
+            return workers + count;
+        }
+
+        [[nodiscard]]
+        uint32_t size() const {
+            return count;
+        }
+    };
+
+    // Scratch GPU memory from ManaRenderContext::allocate_transient(), only valid for the frame it was made in
+    struct ManaTransientAllocation {
+        Internal::VulkanBuffer *vulkan_buffer = nullptr;
+        size_t offset = 0;
+        size_t size = 0;
+
+        // Persistently mapped, anything written here is flushed when the context submits
+        void *data = nullptr;
+    };
+
     // Wraps around a ManaWindow or ManaRenderImage
     // Providing the user with a transparent and seamless way to render to either type of surface
+    //
+    // A frame is recorded in two stages
+    // Offscreen work is recorded first, and is submitted as soon as the target is acquired
+    // The target is acquired as late as possible (by acquire() or the first pass drawing to it)
+    // This keeps the time we hold onto a presentable image short
     class ManaRenderContext {
     protected:
         Internal::VulkanRenderTarget *vulkan_rt = nullptr;
         ManaInstance *owner = nullptr;
 
         bool submitted = false;
+        bool acquired = false;
+        bool offscreen_recording = false;
+
+        // Set once an offscreen buffer went out this frame, more offscreen work needs a fresh buffer
+        bool offscreen_submitted = false;
+
+        // Skipped contexts couldn't acquire their target, so anything drawing to it is dropped
+        bool skipped = false;
+        bool acquire_attempted = false;
+
+        // The pass currently being recorded, forks inherit from it
+        Internal::VulkanRenderPass *active_pass = nullptr;
+        ManaPassContents active_contents = ManaPassContents::Inline;
+        bool forked = false;
+
+        // Work on other queues that must finish before ours starts, applied to every submission that follows
+        Internal::FixedVector<Internal::VulkanScheduler::TimelineWait, 4> timeline_waits;
+
+        // Our latest submission, what compute contexts wait on
+        Internal::VulkanScheduler::TimelinePoint timeline_point;
 
     public:
-        ManaRenderContext(Internal::VulkanRenderTarget *vulkan_rt, ManaInstance *owner);
+        ManaRenderContext(Internal::VulkanRenderTarget *vulkan_rt, ManaInstance *owner, bool skipped = false);
         ~ManaRenderContext();
 
+        // Submits offscreen work recorded so far, then acquires the target
+        // Returns false if the target couldn't be acquired, the frame is then skipped
+        bool acquire();
+
         void submit();
 
+        // Submits the offscreen work recorded so far, letting other queues depend on it through wait_for()
+        void submit_offscreen();
+
+        // Starts recording compute work for this frame, see ManaComputeContext
+        ManaComputeContext begin_compute();
+
+        // Nothing submitted after this call starts until the compute context's work is done
+        // The compute context is submitted first if it hasn't been already
+        void wait_for(ManaComputeContext &compute);
+
+        // Bump allocates from the frame's transient buffer, no VMA calls once the frame has warmed up
+        // Offsets are aligned for dynamic uniform and storage buffer bindings unless an alignment is given
+        ManaTransientAllocation allocate_transient(size_t size, size_t alignment = 0);
+
+        // Allocates and copies in one go
+        ManaTransientAllocation push_transient(const void *data, size_t size);
+
+        // Returns the command buffer for the current stage, beginning it if this is its first use
+        // Null once the frame was skipped by a failed acquire, nothing recorded from then on would ever run
+        Internal::VulkanCmdBuffer *get_active_cmd_buffer();
+
+        // Splits the active pass into count secondary buffers that can be recorded in parallel
+        // The pass must have been begun with ManaPassContents::Secondary, and must be joined before it ends
+        // Returns no workers once the frame was skipped
+        ManaWorkerList fork(uint32_t count);
+
+        // Ends the worker buffers and executes them in order, call once every worker is done recording
+        void join(const ManaWorkerList &workers);
+
+        // Called by ManaRenderPass, a null pass means no pass is active
+        void set_active_pass(Internal::VulkanRenderPass *vulkan_render_pass, ManaPassContents contents);
+
         //
         // Getters
         //
@@ -61,6 +197,33 @@ namespace ManaVK {
         ManaInstance *get_owner() const {
             return owner;
         }
+
+        [[nodiscard]]
+        bool is_skipped() const {
+            return skipped;
+        }
+
+        // Skipped and past the acquire, so nothing more can be recorded this frame
+        [[nodiscard]]
+        bool is_dropped() const {
+            return skipped && acquire_attempted;
+        }
+
+        [[nodiscard]]
+        bool is_acquired() const {
+            return acquired;
+        }
+
+        [[nodiscard]]
+        bool is_forked() const {
+            return forked;
+        }
+
+        // Invalid until something has been submitted
+        [[nodiscard]]
+        const Internal::VulkanScheduler::TimelinePoint &get_timeline_point() const {
+            return timeline_point;
+        }
     };
 }
 
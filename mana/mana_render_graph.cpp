@@ -0,0 +1,222 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mana_render_graph.hpp"
+
+#include <mana/internal/vulkan_render_graph.hpp>
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_render_target.hpp>
+
+#include <mana/mana_instance.hpp>
+
+#include <stdexcept>
+
+using namespace ManaVK;
+
+ManaVK::ManaRenderGraph::ManaRenderGraph(ManaInstance *owner) {
+    if (owner == nullptr) {
+        throw std::runtime_error("owner was nullptr!");
+    }
+
+    this->owner = owner;
+    this->vulkan_render_graph = std::make_unique<Internal::VulkanRenderGraph>();
+}
+
+ManaVK::ManaRenderGraph::~ManaRenderGraph() {
+    release();
+}
+
+void ManaVK::ManaRenderGraph::release() {
+    if (owner == nullptr) {
+        throw std::runtime_error("Owner was nullptr! This object is unable to be released, causing a memory leak!");
+    }
+
+    if (vulkan_render_graph != nullptr) {
+        std::shared_ptr<Internal::VulkanRenderGraph> graph = std::move(vulkan_render_graph);
+
+        auto func = [graph](ManaInstance* p_instance) {
+            graph->release(p_instance->get_vulkan_instance().get());
+        };
+
+        owner->enqueue_release(func);
+        vulkan_render_graph = nullptr;
+    }
+
+    pass_funcs.clear();
+}
+
+//
+// Declaration
+//
+ManaRenderGraph::Resource ManaRenderGraph::create_color(const std::string &name, ManaColorFormat format, float scale) {
+    Internal::VulkanRenderGraph::ImageDesc desc;
+    {
+        desc.vk_format = static_cast<VkFormat>(owner->get_vk_color_format(format));
+        desc.scale = scale;
+    }
+
+    return vulkan_render_graph->create_image(name, desc);
+}
+
+ManaRenderGraph::Resource ManaRenderGraph::create_depth(const std::string &name, ManaDepthFormat format, float scale) {
+    Internal::VulkanRenderGraph::ImageDesc desc;
+    {
+        desc.vk_format = static_cast<VkFormat>(owner->get_vk_depth_format(format));
+        desc.scale = scale;
+        desc.depth = true;
+    }
+
+    return vulkan_render_graph->create_image(name, desc);
+}
+
+ManaRenderGraph::Resource ManaRenderGraph::import_target(const std::string &name) {
+    return vulkan_render_graph->import_target(name);
+}
+
+void ManaRenderGraph::mark_output(Resource resource) {
+    vulkan_render_graph->mark_output(resource);
+}
+
+ManaRenderGraph::Pass ManaRenderGraph::add_pass(const std::string &name, PassFunc func) {
+    Pass pass = vulkan_render_graph->add_pass(name);
+    pass_funcs.emplace_back(std::move(func));
+
+    return pass;
+}
+
+void ManaRenderGraph::write_color(Pass pass, Resource resource, const float *clear_rgba) {
+    if (clear_rgba == nullptr) {
+        vulkan_render_graph->write_color(pass, resource);
+        return;
+    }
+
+    VkClearColorValue vk_clear {};
+    {
+        for (int c = 0; c < 4; c++) {
+            vk_clear.float32[c] = clear_rgba[c];
+        }
+    }
+
+    vulkan_render_graph->write_color(pass, resource, &vk_clear);
+}
+
+void ManaRenderGraph::write_depth(Pass pass, Resource resource, const float *clear_depth) {
+    if (clear_depth == nullptr) {
+        vulkan_render_graph->write_depth(pass, resource);
+        return;
+    }
+
+    VkClearDepthStencilValue vk_clear {};
+    {
+        vk_clear.depth = *clear_depth;
+    }
+
+    vulkan_render_graph->write_depth(pass, resource, &vk_clear);
+}
+
+void ManaRenderGraph::read(Pass pass, Resource resource) {
+    vulkan_render_graph->read(pass, resource);
+}
+
+void ManaRenderGraph::set_side_effects(Pass pass) {
+    vulkan_render_graph->set_side_effects(pass);
+}
+
+void ManaRenderGraph::clear() {
+    vulkan_render_graph->clear();
+    pass_funcs.clear();
+}
+
+//
+// Execution
+//
+void ManaRenderGraph::execute(ManaRenderContext &context) {
+    if (vulkan_render_graph == nullptr) {
+        throw std::runtime_error("vulkan_render_graph was nullptr!");
+    }
+
+    if (context.is_skipped()) {
+        return;
+    }
+
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+    VkExtent2D vk_extent = context.get_vulkan_rt()->get_vk_extent();
+
+    if (vulkan_render_graph->needs_compile(vk_extent)) {
+        std::shared_ptr<Internal::VulkanRenderGraph::Compiled> previous = vulkan_render_graph->compile(vulkan_instance, vk_extent);
+
+        // Frames in flight may still be using the old images
+        if (previous != nullptr) {
+            auto func = [previous](ManaInstance* p_instance) {
+                Internal::VulkanRenderGraph::release_compiled(p_instance->get_vulkan_instance().get(), *previous);
+            };
+
+            owner->enqueue_release(func);
+        }
+    }
+
+    const auto &schedule = vulkan_render_graph->get_schedule();
+
+    for (uint32_t s = 0; s < schedule.size(); s++) {
+        const PassFunc &func = pass_funcs[schedule[s]];
+
+        // The target pass begins the target's own render pass, which acquires it
+        if (vulkan_render_graph->is_target_pass(schedule[s])) {
+            if (func) {
+                func(context);
+            }
+
+            continue;
+        }
+
+        // Recorded before the target is acquired, so these go out with the offscreen submission
+        // A target pass that failed to acquire drops the rest of the frame
+        auto vulkan_cmd_buffer = context.get_active_cmd_buffer();
+
+        if (vulkan_cmd_buffer == nullptr) {
+            return;
+        }
+
+        vulkan_render_graph->begin_pass(vulkan_instance, vulkan_cmd_buffer, s);
+        context.set_active_pass(vulkan_render_graph->get_vulkan_render_pass(s), ManaPassContents::Inline);
+
+        if (func) {
+            func(context);
+        }
+
+        context.set_active_pass(nullptr, ManaPassContents::Inline);
+        vulkan_render_graph->end_pass(vulkan_instance, vulkan_cmd_buffer, s);
+    }
+}
+
+//
+// Getters
+//
+Internal::VulkanImage *ManaRenderGraph::get_vulkan_image(Resource resource) const {
+    if (vulkan_render_graph == nullptr) {
+        return nullptr;
+    }
+
+    return vulkan_render_graph->get_vulkan_image(resource);
+}
@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef MANA_MANA_RENDER_GRAPH_HPP
+#define MANA_MANA_RENDER_GRAPH_HPP
+
+#include <memory>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <mana/mana_enums.hpp>
+#include <mana/mana_render_context.hpp>
+
+namespace ManaVK::Internal {
+    class VulkanImage;
+    class VulkanRenderGraph;
+}
+
+namespace ManaVK {
+    class ManaInstance;
+
+    // Declares a frame as passes reading and writing images, see Internal::VulkanRenderGraph
+    // Declare once and execute every frame, the graph is only recompiled when it or the target size changes
+    //
+    // Graph passes are begun and ended for you, their callbacks only bind and draw
+    // The pass writing the imported target must be last, and begins the target's ManaRenderPass itself
+    class ManaRenderGraph {
+    public:
+        using Resource = uint32_t;
+        using Pass = uint32_t;
+
+        using PassFunc = std::function<void(ManaRenderContext&)>;
+
+    protected:
+        ManaInstance *owner;
+        std::unique_ptr<Internal::VulkanRenderGraph> vulkan_render_graph;
+
+        // Indexed by pass
+        std::vector<PassFunc> pass_funcs;
+
+    public:
+        explicit ManaRenderGraph(ManaInstance *owner);
+        ~ManaRenderGraph();
+
+        Resource create_color(const std::string &name, ManaColorFormat format = ManaColorFormat::Default, float scale = 1.0f);
+        Resource create_depth(const std::string &name, ManaDepthFormat format = ManaDepthFormat::Default, float scale = 1.0f);
+
+        // The target of the context the graph is executed with
+        Resource import_target(const std::string &name = "target");
+
+        // Keeps the image and whatever wrote it alive even if no pass reads it
+        void mark_output(Resource resource);
+
+        Pass add_pass(const std::string &name, PassFunc func);
+
+        // Without a clear value the previous contents are loaded, or are undefined if nothing wrote them yet
+        void write_color(Pass pass, Resource resource, const float *clear_rgba = nullptr);
+        void write_depth(Pass pass, Resource resource, const float *clear_depth = nullptr);
+        void read(Pass pass, Resource resource);
+
+        // Never culled, even if nothing it writes is used
+        void set_side_effects(Pass pass);
+
+        // Forgets every pass and resource, the compiled graph is freed on the next execute()
+        void clear();
+
+        void execute(ManaRenderContext &context);
+
+        void release();
+
+    public:
+        //
+        // Getters
+        //
+
+        // Null until the graph has been compiled, or if the resource was culled
+        [[nodiscard]]
+        Internal::VulkanImage *get_vulkan_image(Resource resource) const;
+    };
+}
+
+#endif//MANA_MANA_RENDER_GRAPH_HPP
@@ -25,6 +25,7 @@ SOFTWARE.
 #include "mana_render_pass.hpp"
 
 #include <mana/internal/vulkan_render_pass.hpp>
+#include <mana/internal/vulkan_framebuffer_cache.hpp>
 #include <mana/internal/vulkan_instance.hpp>
 #include <mana/internal/vulkan_render_target.hpp>
 
@@ -51,7 +52,10 @@ void ManaVK::ManaRenderPass::release() {
 
     if (vulkan_render_pass != nullptr) {
         auto func = [vulkan_render_pass = vulkan_render_pass](ManaInstance* p_instance) {
-            vulkan_render_pass->release(p_instance->get_vulkan_instance()->get_vk_device());
+            const auto &vulkan_instance = p_instance->get_vulkan_instance();
+
+            vulkan_instance->get_framebuffer_cache()->evict_pass(vulkan_instance->get_vk_device(), vulkan_render_pass.get());
+            vulkan_render_pass->release(vulkan_instance->get_vk_device());
         };
 
         owner->enqueue_release(func);
@@ -60,14 +64,24 @@ void ManaVK::ManaRenderPass::release() {
 }
 
 
-void ManaRenderPass::begin(ManaRenderContext& context) {
+bool ManaRenderPass::begin(ManaRenderContext& context, ManaPassContents contents) {
     if (vulkan_render_pass == nullptr) {
         throw std::runtime_error("vulkan_render_pass was nullptr!");
     }
 
+    // Every pass draws to the context's target, so this is where the late acquire happens
+    if (!context.acquire()) {
+        return false;
+    }
+
     Internal::VulkanRenderPass::StateInfo info {};
     {
         info.vulkan_render_target = context.get_vulkan_rt();
+        info.vulkan_cmd_buffer = context.get_active_cmd_buffer();
+
+        if (contents == ManaPassContents::Secondary) {
+            info.vk_subpass_contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+        }
 
         // TODO: Render rect
         // TODO: Clear values
@@ -76,6 +90,9 @@ void ManaRenderPass::begin(ManaRenderContext& context) {
     }
 
     vulkan_render_pass->begin(context.get_owner()->get_vulkan_instance().get(), info);
+    context.set_active_pass(vulkan_render_pass.get(), contents);
+
+    return true;
 }
 
 void ManaRenderPass::end(ManaVK::ManaRenderContext &context) {
@@ -83,10 +100,16 @@ void ManaRenderPass::end(ManaVK::ManaRenderContext &context) {
         throw std::runtime_error("vulkan_render_pass was nullptr!");
     }
 
+    if (!context.is_acquired()) {
+        return;
+    }
+
     Internal::VulkanRenderPass::StateInfo info {};
     {
         info.vulkan_render_target = context.get_vulkan_rt();
+        info.vulkan_cmd_buffer = context.get_active_cmd_buffer();
     }
 
-    vulkan_render_pass->end(info);
+    context.set_active_pass(nullptr, ManaPassContents::Inline);
+    vulkan_render_pass->end(context.get_owner()->get_vulkan_instance().get(), info);
 }
\ No newline at end of file
@@ -45,7 +45,9 @@ namespace ManaVK {
         ManaRenderPass(std::shared_ptr<Internal::VulkanRenderPass> render_pass, ManaInstance *owner);
         ~ManaRenderPass();
 
-        void begin(ManaRenderContext& context);
+        // Secondary passes are recorded through ManaRenderContext::fork() and join()
+        // Returns false if the target couldn't be acquired, the frame is skipped and nothing should be drawn
+        bool begin(ManaRenderContext& context, ManaPassContents contents = ManaPassContents::Inline);
         void end(ManaRenderContext& context);
 
         void release();
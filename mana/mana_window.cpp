@@ -39,13 +39,23 @@ ManaWindow::ManaWindow(Internal::VulkanWindow *vulkan_window, ManaInstance *owne
 }
 
 ManaRenderContext ManaWindow::new_frame() {
-    // TODO: Frames in flight
-    vulkan_window->await_frame(owner->get_vulkan_instance().get());
-    return ManaRenderContext(vulkan_window, owner);
+    auto vulkan_instance = owner->get_vulkan_instance().get();
+
+    // Only blocks when the GPU is still using the frame slot we're about to record into
+    vulkan_window->await_frame(vulkan_instance);
+
+    if (dirty || vulkan_window->is_swapchain_dirty()) {
+        vulkan_window->recreate_swapchain(vulkan_instance);
+        dirty = false;
+    }
+
+    // The image itself is acquired late by the context, right before the first pass that draws to the window
+    // Still being dirty here means the window can't be presented to (e.g. minimized)
+    return ManaRenderContext(vulkan_window, owner, vulkan_window->is_swapchain_dirty());
 }
 
 void ManaWindow::flush(ManaInstance *mana_instance) {
-    if (dirty) {
+    if (dirty || vulkan_window->is_swapchain_dirty()) {
         vulkan_window->recreate_swapchain(mana_instance->get_vulkan_instance().get());
         dirty = false;
     }
@@ -0,0 +1,255 @@
+/*
+MIT License
+
+Copyright (c) 2023 zCubed (Liam R.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Counts heap allocations made while recording and submitting a frame, a warmed up frame must not allocate
+// Needs a GPU and a display, it opens a window for a few frames
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <mana/internal/vulkan_instance.hpp>
+#include <mana/internal/vulkan_render_pass_builder.hpp>
+
+#include <mana/mana_instance.hpp>
+#include <mana/mana_pipeline.hpp>
+#include <mana/mana_render_pass.hpp>
+#include <mana/mana_window.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+#define LOG_INLINE(args) std::cout << "[ManaVK::Tests::FrameAllocations]: "<< args
+#define LOG(args) LOG_INLINE(args) << std::endl
+
+//
+// Counting allocator
+//
+// Only the thread recording the frame is counted, pipeline compiler workers are free to allocate
+static thread_local bool counting = false;
+static std::atomic<size_t> allocation_count = 0;
+
+static void *counted_alloc(size_t size) {
+    if (counting) {
+        allocation_count++;
+    }
+
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+static void *counted_aligned_alloc(size_t size, std::align_val_t alignment) {
+    if (counting) {
+        allocation_count++;
+    }
+
+    // aligned_alloc wants the size to be a multiple of the alignment
+    auto align = static_cast<size_t>(alignment);
+    void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align);
+
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void *operator new(size_t size) {
+    return counted_alloc(size);
+}
+
+void *operator new[](size_t size) {
+    return counted_alloc(size);
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return counted_aligned_alloc(size, alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return counted_aligned_alloc(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+//
+// Pipeline
+//
+using namespace ManaVK;
+
+// Clears the window, the least a frame can do while still going through begin / end
+class ClearPipeline : public ManaPipeline {
+protected:
+    std::shared_ptr<ManaRenderPass> window_pass;
+
+public:
+    void initialize(ManaInstance *owner) override {
+        const auto &vulkan_instance = owner->get_vulkan_instance();
+
+        Internal::VulkanRenderPassBuilder builder;
+
+        Internal::VulkanRenderPassBuilder::AttachmentInfo color_info {};
+        {
+            color_info.vk_format = static_cast<VkFormat>(owner->get_vk_color_format(ManaColorFormat::Default));
+            color_info.vk_load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            color_info.vk_store_op = VK_ATTACHMENT_STORE_OP_STORE;
+            color_info.vk_layout_ref = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            color_info.vk_layout_final = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        }
+
+        builder.push_color_attachment(color_info);
+
+        Internal::VulkanRenderPassBuilder::SubpassInfo subpass_info {};
+        {
+            subpass_info.output_indices = { 0 };
+        }
+
+        builder.push_subpass(subpass_info);
+
+        auto vulkan_render_pass = builder.build(vulkan_instance->get_vk_device(), vulkan_instance->get_render_pass_cache());
+        window_pass = std::make_shared<ManaRenderPass>(vulkan_render_pass, owner);
+    }
+
+    void new_frame(ManaRenderContext &context) override {
+        window_pass->begin(context);
+        window_pass->end(context);
+    }
+
+    std::shared_ptr<ManaRenderPass> get_window_render_pass() const override {
+        return window_pass;
+    }
+};
+
+//
+// Test
+//
+int main() {
+    // Every frame slot (and its arena) has been used at least once after this many frames
+    constexpr uint32_t WARM_UP_FRAMES = 8;
+    constexpr uint32_t COUNTED_FRAMES = 32;
+
+    // The instance must hold the only reference to the pipeline
+    // ~ManaInstance drops it before draining the release queue, its passes would release into a dead instance otherwise
+    std::unique_ptr<ManaInstance> instance;
+    ClearPipeline *pipeline = nullptr;
+
+    {
+        auto clear_pipeline = std::make_shared<ClearPipeline>();
+        pipeline = clear_pipeline.get();
+
+        ManaInstance::ManaConfig config;
+        {
+            config.mana_pipeline = std::move(clear_pipeline);
+            config.window_settings.title = "ManaVK Frame Allocations";
+            config.window_settings.resizable = false;
+
+            // Keeps background compiles from touching the disk, they aren't counted either way
+            config.cache_settings.pipeline_cache_dir = "";
+        }
+
+        instance = std::make_unique<ManaInstance>(config);
+    }
+
+    auto window = instance->get_main_window();
+
+    size_t worst_frame = 0;
+
+    for (uint32_t f = 0; f < WARM_UP_FRAMES + COUNTED_FRAMES; f++) {
+        SDL_PumpEvents();
+
+        // Releases and uploads run between frames, they aren't part of recording one
+        instance->flush();
+
+        bool counted = f >= WARM_UP_FRAMES;
+        size_t before = allocation_count.load();
+
+        counting = counted;
+
+        {
+            ManaRenderContext context = window->new_frame();
+
+            pipeline->new_frame(context);
+            context.submit();
+        }
+
+        counting = false;
+
+        if (counted) {
+            size_t allocations = allocation_count.load() - before;
+
+            if (allocations > worst_frame) {
+                worst_frame = allocations;
+            }
+
+            if (allocations != 0) {
+                LOG("Frame " << f << " allocated " << allocations << " time(s)");
+            }
+        }
+    }
+
+    if (worst_frame != 0) {
+        LOG("FAILED: A warmed up frame allocated up to " << worst_frame << " time(s), expected none");
+        return EXIT_FAILURE;
+    }
+
+    LOG("PASSED: " << COUNTED_FRAMES << " frames recorded and submitted without allocating");
+    return EXIT_SUCCESS;
+}